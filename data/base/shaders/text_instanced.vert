@@ -0,0 +1,29 @@
+// Version directive is set by Warzone when loading the shader
+// (This shader supports GLSL 1.20 - 1.50 core.)
+
+#if (!defined(GL_ES) && (__VERSION__ >= 130)) || (defined(GL_ES) && (__VERSION__ >= 300))
+#define NEWGL
+#endif
+
+uniform mat4 transformationMatrix;
+
+#ifdef NEWGL
+#define VERTEX_INPUT in
+#define VERTEX_OUTPUT out
+#else
+#define VERTEX_INPUT attribute
+#define VERTEX_OUTPUT varying
+#endif
+
+VERTEX_INPUT vec4 vertex;
+VERTEX_INPUT vec4 instanceGlyphRect; // vec2 (position), vec2 (size)
+VERTEX_INPUT vec4 instanceGlyphUV; // vec2 (offset), vec2 (scale)
+
+VERTEX_OUTPUT vec2 uv;
+
+void main()
+{
+	vec2 glyphPosition = instanceGlyphRect.xy + instanceGlyphRect.zw * vertex.xy;
+	gl_Position = transformationMatrix * vec4(glyphPosition, 0.0, 1.0);
+	uv = instanceGlyphUV.zw * vertex.xy + instanceGlyphUV.xy;
+}
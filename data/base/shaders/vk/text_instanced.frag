@@ -0,0 +1,17 @@
+#version 450
+
+layout(std140, set = 0, binding = 0) uniform cbuffer {
+	mat4 transformationMatrix;
+	vec4 color;
+};
+
+layout(set = 1, binding = 0) uniform sampler2D tex;
+
+layout(location = 0) in vec2 uv;
+layout(location = 0) out vec4 FragColor;
+
+void main()
+{
+	vec4 texColour = texture(tex, uv) * color.a;
+	FragColor = texColour * color;
+}
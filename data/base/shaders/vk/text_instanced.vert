@@ -0,0 +1,21 @@
+#version 450
+
+layout(std140, set = 0, binding = 0) uniform cbuffer {
+	mat4 transformationMatrix;
+	vec4 color;
+};
+
+layout(location = 0) in vec4 vertex;
+layout(location = 5) in vec4 instanceGlyphRect; // vec2 (position), vec2 (size)
+layout(location = 6) in vec4 instanceGlyphUV; // vec2 (offset), vec2 (scale)
+
+layout(location = 0) out vec2 uv;
+
+void main()
+{
+	vec2 glyphPosition = instanceGlyphRect.xy + instanceGlyphRect.zw * vertex.xy;
+	gl_Position = transformationMatrix * vec4(glyphPosition, 0.0, 1.0);
+	uv = instanceGlyphUV.zw * vertex.xy + instanceGlyphUV.xy;
+	gl_Position.y *= -1.;
+	gl_Position.z = (gl_Position.z + gl_Position.w) / 2.0;
+}
@@ -31,12 +31,24 @@
 
 #include "file.h"
 #include "resly.h"
+#include "wzapp.h"
 
 #include <list>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Most worker threads used to prefetch the files of a .wrf
+#define RES_MAX_PREFETCH_THREADS	4
 
 // Local prototypes
 static std::list<RES_TYPE *> psResTypes;
+static std::unordered_map<UDWORD, RES_TYPE *> resTypeIndex;	// HashedType -> entry of psResTypes
 
 /* The initial resource directory and the current resource directory */
 char aResDir[PATH_MAX];
@@ -47,6 +59,7 @@ static SDWORD resBlockID;
 
 // prototypes
 static void ResetResourceFile();
+static bool resRunPendingLoads();
 
 // callback to resload screen.
 static RESLOAD_CALLBACK resLoadCallback = nullptr;
@@ -152,6 +165,7 @@ bool resInitialise()
 	ASSERT(psResTypes.empty(),
 	       "resInitialise: resource module hasn't been shut down??");
 	psResTypes.clear();
+	resTypeIndex.clear();
 	resBlockID = 0;
 	resLoadCallback = nullptr;
 
@@ -184,6 +198,37 @@ void resSetBaseDir(const char *pResDir)
 	sstrcpy(aResDir, pResDir);
 }
 
+/// A resLoadFile() call from the .wrf parser, held back until the whole file has been parsed
+struct RES_PENDING
+{
+	std::string type;
+	std::string file;
+	std::string resDir;		// aCurrResDir at the time of the call
+	std::string fileName;	// the file name passed to the prefetch and load functions
+	RES_PREFETCH prefetch;
+};
+
+#define PREFETCH_PENDING	0
+#define PREFETCH_CLAIMED	1
+#define PREFETCH_DONE		2
+
+static bool resDeferLoads = false;
+static std::vector<RES_PENDING> resPendingLoads;
+static std::unique_ptr<std::atomic<int>[]> resPendingState;	// PREFETCH_* for each of resPendingLoads
+static std::atomic<size_t> resNextPrefetch(0);
+static std::atomic<bool> resStopPrefetch(false);
+static std::mutex resPrefetchMutex;
+static std::condition_variable resPrefetchDone;
+
+struct RES_PREFETCHED
+{
+	void *pData;
+	RES_FREE release;
+};
+
+static std::mutex resPrefetchedMutex;
+static std::unordered_map<std::string, RES_PREFETCHED> resPrefetched;	// file name -> data prefetched for it
+
 /* Parse the res file */
 bool resLoad(const char *pResFile, SDWORD blockID)
 {
@@ -206,17 +251,25 @@ bool resLoad(const char *pResFile, SDWORD blockID)
 		return false;
 	}
 
-	// and parse it
+	// and parse it, collecting the files to load
 	res_set_extra(&input);
-	if (res_parse() != 0)
-	{
-		debug(LOG_FATAL, "Failed to parse %s", pResFile);
-		retval = false;
-	}
+	resDeferLoads = true;
+	retval = res_parse() == 0;
+	resDeferLoads = false;
 
 	res_lex_destroy();
 	PHYSFS_close(input.input.physfsfile);
 
+	// then load them, in the order they were listed
+	if (!resRunPendingLoads())
+	{
+		retval = false;
+	}
+	if (!retval)
+	{
+		debug(LOG_FATAL, "Failed to parse %s", pResFile);
+	}
+
 	return retval;
 }
 
@@ -237,9 +290,40 @@ static RES_TYPE *resAlloc(const char *pType)
 	sstrcpy(psT->aType, pType);
 	psT->HashedType = HashString(psT->aType); // store a hased version for super speed !
 
+	auto it = resTypeIndex.find(psT->HashedType);
+	if (it != resTypeIndex.end())
+	{
+		ASSERT(strcmp(it->second->aType, pType) == 0, "Hash collision \"%s\" vs \"%s\"", it->second->aType, pType);
+	}
+	resTypeIndex[psT->HashedType] = psT;
+
 	return psT;
 }
 
+/* Find the RES_TYPE for a hashed type name */
+static RES_TYPE *resFindType(UDWORD HashedType)
+{
+	auto it = resTypeIndex.find(HashedType);
+	return it != resTypeIndex.end() ? it->second : nullptr;
+}
+
+/* Find the newest resource of a type with the given hashed ID */
+static RES_DATA *resFindData(const RES_TYPE *psT, UDWORD HashedID)
+{
+	auto it = psT->resIndex.find(HashedID);
+	return it != psT->resIndex.end() ? it->second : nullptr;
+}
+
+/* Rebuild the ID index of a type from its resource list, where the newest resource with an ID wins */
+static void resReindexType(RES_TYPE *psT)
+{
+	psT->resIndex.clear();
+	for (auto it = psT->psRes.rbegin(); it != psT->psRes.rend(); ++it)
+	{
+		psT->resIndex[(*it)->HashedID] = *it;
+	}
+}
+
 
 /* Add a buffer load function for a file type */
 bool resAddBufferLoad(const char *pType, RES_BUFFERLOAD buffLoad, RES_FREE release)
@@ -248,6 +332,7 @@ bool resAddBufferLoad(const char *pType, RES_BUFFERLOAD buffLoad, RES_FREE relea
 
 	psT->buffLoad = buffLoad;
 	psT->fileLoad = nullptr;
+	psT->prefetch = nullptr;
 	psT->release = release;
 
 	psResTypes.emplace_front(psT);
@@ -257,12 +342,13 @@ bool resAddBufferLoad(const char *pType, RES_BUFFERLOAD buffLoad, RES_FREE relea
 
 
 /* Add a file name load function for a file type */
-bool resAddFileLoad(const char *pType, RES_FILELOAD fileLoad, RES_FREE release)
+bool resAddFileLoad(const char *pType, RES_FILELOAD fileLoad, RES_FREE release, RES_PREFETCH prefetch)
 {
 	RES_TYPE	*psT = resAlloc(pType);
 
 	psT->buffLoad = nullptr;
 	psT->fileLoad = fileLoad;
+	psT->prefetch = prefetch;
 	psT->release = release;
 
 	psResTypes.emplace_front(psT);
@@ -463,43 +549,31 @@ static void makeLocaleFile(char *fileName, size_t maxlen)  // given string must
  * Call the load function (registered in data.c)
  * for this filetype
  */
-bool resLoadFile(const char *pType, const char *pFile)
+static bool resLoadFileNow(const char *pType, const char *pFile)
 {
 	void		*pData = nullptr;
 	char		aFileName[PATH_MAX];
 	UDWORD HashedName, HashedType = HashString(pType);
 
 	// Find the resource-type
-	auto resTypeIt = std::find_if(psResTypes.begin(), psResTypes.end(), [pType, HashedType](const RES_TYPE* psT)
-	{
-		if (psT->HashedType == HashedType)
-		{
-			ASSERT(strcmp(psT->aType, pType) == 0, "Hash collision \"%s\" vs \"%s\"", psT->aType, pType);
-			return true;
-		}
-		return false;
-	});
-
-	if (resTypeIt == psResTypes.end())
+	RES_TYPE* psT = resFindType(HashedType);
+	if (psT == nullptr)
 	{
 		debug(LOG_WZ, "resLoadFile: Unknown type: %s", pType);
 		return false;
 	}
-	RES_TYPE* psT = *resTypeIt;
+	ASSERT(strcmp(psT->aType, pType) == 0, "Hash collision \"%s\" vs \"%s\"", psT->aType, pType);
 
 	// Check for duplicates
 	HashedName = HashStringIgnoreCase(pFile);
-	for (const RES_DATA* psRes : psT->psRes)
+	if (const RES_DATA* psRes = resFindData(psT, HashedName))
 	{
-		if (psRes->HashedID == HashedName)
-		{
-			ASSERT(strcasecmp(psRes->aID, pFile) == 0, "Hash collision \"%s\" vs \"%s\"", psRes->aID, pFile);
-			debug(LOG_WZ, "Duplicate file name: %s (hash %x) for type %s",
-			      pFile, HashedName, psT->aType);
-			// assume that they are actually both the same and silently fail
-			// lovely little hack to allow some files to be loaded from disk (believe it or not!).
-			return true;
-		}
+		ASSERT(strcasecmp(psRes->aID, pFile) == 0, "Hash collision \"%s\" vs \"%s\"", psRes->aID, pFile);
+		debug(LOG_WZ, "Duplicate file name: %s (hash %x) for type %s",
+		      pFile, HashedName, psT->aType);
+		// assume that they are actually both the same and silently fail
+		// lovely little hack to allow some files to be loaded from disk (believe it or not!).
+		return true;
 	}
 
 	// Create the file name
@@ -572,50 +646,218 @@ bool resLoadFile(const char *pType, const char *pFile)
 		}
 
 		// Add the resource to the list
+		const RES_DATA* psOld = resFindData(psT, psRes->HashedID);
+		ASSERT(psOld == nullptr || strcasecmp(psOld->aID, psRes->aID) == 0, "Hash collision \"%s\" vs \"%s\"", psOld->aID, psRes->aID);
 		psT->psRes.emplace_front(psRes);
+		psT->resIndex[psRes->HashedID] = psRes;
 	}
 	return true;
 }
 
+/*!
+ * Call the load function for this filetype, or, while resLoad()
+ * is parsing a .wrf, queue the call until the parse is done
+ */
+bool resLoadFile(const char *pType, const char *pFile)
+{
+	if (!resDeferLoads)
+	{
+		return resLoadFileNow(pType, pFile);
+	}
+
+	RES_PENDING load;
+	load.type = pType;
+	load.file = pFile;
+	load.resDir = aCurrResDir;
+	load.prefetch = nullptr;
+
+	const RES_TYPE *psT = resFindType(HashString(pType));
+	if (psT != nullptr && psT->prefetch != nullptr && resFindData(psT, HashStringIgnoreCase(pFile)) == nullptr
+	    && strlen(aCurrResDir) + strlen(pFile) + 1 < PATH_MAX)
+	{
+		char aFileName[PATH_MAX];
+		sstrcpy(aFileName, aCurrResDir);
+		sstrcat(aFileName, pFile);
+		makeLocaleFile(aFileName, sizeof(aFileName));
+		load.fileName = aFileName;
+		load.prefetch = psT->prefetch;
+	}
+
+	// errors (unknown type, name too long) are reported when the load is run
+	resPendingLoads.push_back(std::move(load));
+	return true;
+}
+
+void resStorePrefetched(const char *pFile, void *pData, RES_FREE release)
+{
+	std::lock_guard<std::mutex> lock(resPrefetchedMutex);
+	auto it = resPrefetched.find(pFile);
+	if (it != resPrefetched.end() && it->second.release != nullptr)
+	{
+		it->second.release(it->second.pData);
+	}
+	resPrefetched[pFile] = RES_PREFETCHED{pData, release};
+}
+
+void *resTakePrefetched(const char *pFile)
+{
+	std::lock_guard<std::mutex> lock(resPrefetchedMutex);
+	auto it = resPrefetched.find(pFile);
+	if (it == resPrefetched.end())
+	{
+		return nullptr;
+	}
+	void *pData = it->second.pData;
+	resPrefetched.erase(it);
+	return pData;
+}
+
+/* Release any prefetched data that no load function took (e.g. because an earlier load failed) */
+static void resFreePrefetched()
+{
+	std::lock_guard<std::mutex> lock(resPrefetchedMutex);
+	for (auto &it : resPrefetched)
+	{
+		if (it.second.release != nullptr)
+		{
+			it.second.release(it.second.pData);
+		}
+	}
+	resPrefetched.clear();
+}
+
+static bool resClaimPrefetch(size_t i)
+{
+	int expected = PREFETCH_PENDING;
+	return resPendingState[i].compare_exchange_strong(expected, PREFETCH_CLAIMED);
+}
+
+static void resRunPrefetch(size_t i)
+{
+	resPendingLoads[i].prefetch(resPendingLoads[i].fileName.c_str());
+	{
+		std::lock_guard<std::mutex> lock(resPrefetchMutex);
+		resPendingState[i] = PREFETCH_DONE;
+	}
+	resPrefetchDone.notify_all();
+}
+
+/* Worker threads walk the pending loads in order, running ahead of the main thread */
+static int resPrefetchThreadFunc(void *)
+{
+	for (size_t i = resNextPrefetch++; i < resPendingLoads.size() && !resStopPrefetch; i = resNextPrefetch++)
+	{
+		if (resPendingLoads[i].prefetch != nullptr && resClaimPrefetch(i))
+		{
+			resRunPrefetch(i);
+		}
+	}
+	return 0;
+}
+
+/*!
+ * Run the loads queued while parsing a .wrf. Reading and decoding of the
+ * files is spread over worker threads; the load functions themselves run
+ * here, on the main thread, in the order of the .wrf.
+ */
+static bool resRunPendingLoads()
+{
+	const size_t count = resPendingLoads.size();
+	size_t numPrefetches = 0;
+	resPendingState.reset(new std::atomic<int>[count]);
+	for (size_t i = 0; i < count; ++i)
+	{
+		resPendingState[i] = PREFETCH_PENDING;
+		numPrefetches += resPendingLoads[i].prefetch != nullptr ? 1 : 0;
+	}
+	resNextPrefetch = 0;
+	resStopPrefetch = false;
+
+	std::vector<WZ_THREAD *> threads;
+	const size_t numThreads = std::min<size_t>(std::min<size_t>(RES_MAX_PREFETCH_THREADS, std::max(std::thread::hardware_concurrency(), 1u) - 1), numPrefetches / 2);
+	for (size_t i = 0; i < numThreads; ++i)
+	{
+		WZ_THREAD *thread = wzThreadCreate(resPrefetchThreadFunc, nullptr, "wzResPrefetch");
+		wzThreadStart(thread);
+		threads.push_back(thread);
+	}
+
+	bool retval = true;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const RES_PENDING &load = resPendingLoads[i];
+		if (load.prefetch != nullptr)
+		{
+			if (resClaimPrefetch(i))
+			{
+				resRunPrefetch(i);
+			}
+			else
+			{
+				std::unique_lock<std::mutex> lock(resPrefetchMutex);
+				resPrefetchDone.wait(lock, [i] { return resPendingState[i] == PREFETCH_DONE; });
+			}
+		}
+
+		sstrcpy(aCurrResDir, load.resDir.c_str());
+		if (!resLoadFileNow(load.type.c_str(), load.file.c_str()))
+		{
+			retval = false;
+			break;
+		}
+	}
+
+	resStopPrefetch = true;
+	for (WZ_THREAD *thread : threads)
+	{
+		wzThreadJoin(thread);
+	}
+	resPendingLoads.clear();
+	resPendingState.reset();
+	resFreePrefetched();
+
+	return retval;
+}
+
 /* Return the resource for a type and hashedname */
 void *resGetDataFromHash(const char *pType, UDWORD HashedID)
 {
 	// Find the correct type
 	UDWORD HashedType = HashString(pType);
 
-	auto resTypeIt = std::find_if(psResTypes.begin(), psResTypes.end(), [HashedType](const RES_TYPE* psT)
-	{
-		return psT->HashedType == HashedType;
-	});
-	ASSERT(resTypeIt != psResTypes.end(), "resGetDataFromHash: Unknown type: %s", pType);
-	if (resTypeIt == psResTypes.end())
+	RES_TYPE* psT = resFindType(HashedType);
+	ASSERT(psT != nullptr, "resGetDataFromHash: Unknown type: %s", pType);
+	if (psT == nullptr)
 	{
 		return nullptr;
 	}
-	RES_TYPE* psT = *resTypeIt;
-
-	auto res = std::find_if(psT->psRes.begin(), psT->psRes.end(), [HashedID](const RES_DATA* rd)
-	{
-		return rd->HashedID == HashedID;
-	});
 
-	ASSERT(res != psT->psRes.end(), "resGetDataFromHash: Unknown ID: %0x Type: %s", HashedID, pType);
-	if (res == psT->psRes.end())
+	RES_DATA* psRes = resFindData(psT, HashedID);
+	ASSERT(psRes != nullptr, "resGetDataFromHash: Unknown ID: %0x Type: %s", HashedID, pType);
+	if (psRes == nullptr)
 	{
 		return nullptr;
 	}
 
-	(*res)->usage += 1;
+	psRes->usage += 1;
 
-	return (*res)->pData;
+	return psRes->pData;
 }
 
 
 /* Return the resource for a type and ID */
 void *resGetData(const char *pType, const char *pID)
 {
-	void *data = resGetDataFromHash(pType, HashStringIgnoreCase(pID));
+	const UDWORD HashedID = HashStringIgnoreCase(pID);
+	void *data = resGetDataFromHash(pType, HashedID);
 	ASSERT(data != nullptr, "resGetData: Unable to find data for %s type %s", pID, pType);
+#ifdef DEBUG
+	if (data != nullptr)
+	{
+		const RES_DATA* psRes = resFindData(resFindType(HashString(pType)), HashedID);
+		ASSERT(strcasecmp(psRes->aID, pID) == 0, "Hash collision \"%s\" vs \"%s\"", psRes->aID, pID);
+	}
+#endif
 	return data;
 }
 
@@ -625,12 +867,8 @@ bool resGetHashfromData(const char *pType, const void *pData, UDWORD *pHash)
 	// Find the correct type
 	UDWORD	HashedType = HashString(pType);
 
-	auto resTypeIt = std::find_if(psResTypes.begin(), psResTypes.end(), [HashedType](const RES_TYPE* psT)
-	{
-		return psT->HashedType == HashedType;
-	});
-	ASSERT_OR_RETURN(false, resTypeIt != psResTypes.end(), "Unknown type: %x", HashedType);
-	RES_TYPE* psT = *resTypeIt;
+	RES_TYPE* psT = resFindType(HashedType);
+	ASSERT_OR_RETURN(false, psT != nullptr, "Unknown type: %x", HashedType);
 
 	// Find the resource
 	auto res = std::find_if(psT->psRes.begin(), psT->psRes.end(), [pData](const RES_DATA* rd)
@@ -662,16 +900,12 @@ const char *resGetNamefromData(const char *type, const void *data)
 	HashedType = HashString(type);
 
 	// Find the resource table for the given type
-	auto resTypeIt = std::find_if(psResTypes.begin(), psResTypes.end(), [HashedType](const RES_TYPE* psT)
-	{
-		return psT->HashedType == HashedType;
-	});
-	if (resTypeIt == psResTypes.end())
+	RES_TYPE* psT = resFindType(HashedType);
+	if (psT == nullptr)
 	{
 		ASSERT(false, "resGetHashfromData: Unknown type: %x", HashedType);
 		return "";
 	}
-	RES_TYPE* psT = *resTypeIt;
 
 	// Find the resource in the resource table
 	auto res = std::find_if(psT->psRes.begin(), psT->psRes.end(), [data](const RES_DATA* rd)
@@ -694,24 +928,15 @@ bool resPresent(const char *pType, const char *pID)
 	// Find the correct type
 	UDWORD HashedType = HashString(pType);
 
-	auto resTypeIt = std::find_if(psResTypes.begin(), psResTypes.end(), [HashedType](const RES_TYPE* psT)
-	{
-		return psT->HashedType == HashedType;
-	});
+	RES_TYPE* psT = resFindType(HashedType);
 	/* Bow out if unrecognised type */
-	ASSERT(resTypeIt != psResTypes.end(), "resPresent: Unknown type");
-	if (resTypeIt == psResTypes.end())
+	ASSERT(psT != nullptr, "resPresent: Unknown type");
+	if (psT == nullptr)
 	{
 		return false;
 	}
-	RES_TYPE* psT = *resTypeIt;
 
-	UDWORD HashedID = HashStringIgnoreCase(pID);
-	auto res = std::find_if(psT->psRes.begin(), psT->psRes.end(), [HashedID](const RES_DATA* rd)
-	{
-		return rd->HashedID == HashedID;
-	});
-	return res != psT->psRes.end();
+	return resFindData(psT, HashStringIgnoreCase(pID)) != nullptr;
 }
 
 
@@ -726,6 +951,7 @@ void resReleaseAll()
 	}
 
 	psResTypes.clear();
+	resTypeIndex.clear();
 }
 
 
@@ -748,6 +974,7 @@ void resReleaseAllData()
 			return IterationResult::CONTINUE_ITERATION;
 		});
 		psT->psRes.clear();
+		psT->resIndex.clear();
 	}
 }
 
@@ -757,7 +984,8 @@ void resReleaseBlockData(SDWORD blockID)
 {
 	for (RES_TYPE* psT : psResTypes)
 	{
-		mutating_list_iterate(psT->psRes, [psT, blockID](std::list<RES_DATA*>::iterator resIt)
+		bool released = false;
+		mutating_list_iterate(psT->psRes, [psT, blockID, &released](std::list<RES_DATA*>::iterator resIt)
 		{
 			RES_DATA* psRes = *resIt;
 			if (psRes->blockID != blockID)
@@ -776,7 +1004,12 @@ void resReleaseBlockData(SDWORD blockID)
 
 			psT->psRes.erase(resIt);
 			free(psRes);
+			released = true;
 			return IterationResult::CONTINUE_ITERATION;
 		});
+		if (released)
+		{
+			resReindexType(psT);
+		}
 	}
 }
@@ -27,6 +27,7 @@
 #include "lib/framework/frame.h"
 
 #include <list>
+#include <unordered_map>
 
 /** Maximum number of characters in a resource type. */
 #define RESTYPE_MAXCHAR		20
@@ -41,6 +42,10 @@ typedef bool (*RES_FILELOAD)(const char *pFile, void **pData);
 /** Function pointer for releasing a resource loaded by the above functions. */
 typedef void (*RES_FREE)(void *pData);
 
+/** Function pointer for a function that reads and decodes a file ahead of its load function, on a worker thread.
+ *  It must not touch any game state: it may only hand its result to the load function with resStorePrefetched(). */
+typedef void (*RES_PREFETCH)(const char *pFile);
+
 /** callback type for resload display callback. */
 typedef void (*RESLOAD_CALLBACK)();
 
@@ -69,9 +74,11 @@ struct RES_TYPE
 
 	// we must have a pointer to the data here so that we can do a resGetData();
 	std::list<RES_DATA*> psRes;		// Linked list of data items of this type
+	std::unordered_map<UDWORD, RES_DATA*> resIndex;	// HashedID -> the newest item in psRes with that ID
 	UDWORD	HashedType;				// hashed version of the name of the id - // a null hashedtype indicates end of list
 
 	RES_FILELOAD	fileLoad;		// This isn't really used any more ?
+	RES_PREFETCH	prefetch;		// routine to read the file ahead of fileLoad on a worker thread (NULL indicates none)
 };
 
 
@@ -106,12 +113,18 @@ void resReleaseAllData();
 /** Add a buffer load and release function for a file type. */
 WZ_DECL_NONNULL(1) bool resAddBufferLoad(const char *pType, RES_BUFFERLOAD buffLoad, RES_FREE release);
 
-/** Add a file name load and release function for a file type. */
-WZ_DECL_NONNULL(1) bool resAddFileLoad(const char *pType, RES_FILELOAD fileLoad, RES_FREE release);
+/** Add a file name load and release function for a file type, and optionally a prefetch function. */
+WZ_DECL_NONNULL(1) bool resAddFileLoad(const char *pType, RES_FILELOAD fileLoad, RES_FREE release, RES_PREFETCH prefetch = nullptr);
 
 /** Call the load function for a file. */
 WZ_DECL_NONNULL(1, 2) bool resLoadFile(const char *pType, const char *pFile);
 
+/** Hand the result of a prefetch to the load function of the same file. May be called from any thread. */
+WZ_DECL_NONNULL(1) void resStorePrefetched(const char *pFile, void *pData, RES_FREE release);
+
+/** Take the prefetched data for a file, if there is any. The caller becomes responsible for releasing it. */
+WZ_DECL_NONNULL(1) void *resTakePrefetched(const char *pFile);
+
 /** Return the resource for a type and ID */
 WZ_DECL_NONNULL(1) void *resGetDataFromHash(const char *pType, UDWORD HashedID);
 WZ_DECL_NONNULL(1, 2) void *resGetData(const char *pType, const char *pID);
@@ -29,6 +29,7 @@
 #include <sstream>
 #include <limits>
 #include "physfs_ext.h"
+#include "frameresource.h"
 
 WzConfig::~WzConfig()
 {
@@ -79,44 +80,58 @@ WzConfig::WzConfig(const WzString &name, WzConfig::warning warning)
 	mWarning = warning;
 	pCurrentObj = &mRoot;
 
-	if (!PHYSFS_exists(name.toUtf8().c_str()))
+	nlohmann::json *prefetched = nullptr;
+	if (warning != ReadAndWrite)
 	{
-		if (warning == ReadOnly)
-		{
-			mStatus = false;
-			return;
-		}
-		else if (warning == ReadOnlyAndRequired)
+		prefetched = static_cast<nlohmann::json *>(resTakePrefetched(name.toUtf8().c_str()));
+	}
+	if (prefetched)
+	{
+		// already read and parsed while the resource file was being loaded, see wzConfigPrefetch()
+		mRoot = std::move(*prefetched);
+		delete prefetched;
+	}
+	else
+	{
+		if (!PHYSFS_exists(name.toUtf8().c_str()))
 		{
-			debug(LOG_FATAL, "Missing required file %s", name.toUtf8().c_str());
-			abort();
+			if (warning == ReadOnly)
+			{
+				mStatus = false;
+				return;
+			}
+			else if (warning == ReadOnlyAndRequired)
+			{
+				debug(LOG_FATAL, "Missing required file %s", name.toUtf8().c_str());
+				abort();
+			}
+			else if (warning == ReadAndWrite)
+			{
+				return;
+			}
 		}
-		else if (warning == ReadAndWrite)
+		if (!loadFile(name.toUtf8().c_str(), &data, &size))
 		{
+			mStatus = false;
+			debug(LOG_FATAL, "Could not open \"%s\"", name.toUtf8().c_str());
 			return;
 		}
-	}
-	if (!loadFile(name.toUtf8().c_str(), &data, &size))
-	{
-		mStatus = false;
-		debug(LOG_FATAL, "Could not open \"%s\"", name.toUtf8().c_str());
-		return;
-	}
-	ASSERT_OR_RETURN(, data != nullptr, "Null data?");
+		ASSERT_OR_RETURN(, data != nullptr, "Null data?");
 
-	try {
-		mRoot = nlohmann::json::parse(data, data + size);
-	}
-	catch (const std::exception &e) {
-		ASSERT(false, "JSON document from %s is invalid: %s", name.toUtf8().c_str(), e.what());
-	}
-	catch (...) {
-		debug(LOG_FATAL, "Unexpected exception parsing JSON %s", name.toUtf8().c_str());
+		try {
+			mRoot = nlohmann::json::parse(data, data + size);
+		}
+		catch (const std::exception &e) {
+			ASSERT(false, "JSON document from %s is invalid: %s", name.toUtf8().c_str(), e.what());
+		}
+		catch (...) {
+			debug(LOG_FATAL, "Unexpected exception parsing JSON %s", name.toUtf8().c_str());
+		}
+		pCurrentObj = &mRoot;
+		ASSERT(!mRoot.is_null(), "JSON document from %s is null", name.toUtf8().c_str());
+		ASSERT(mRoot.is_object(), "JSON document from %s is not an object. Read: \n%s", name.toUtf8().c_str(), data);
+		free(data);
 	}
-	pCurrentObj = &mRoot;
-	ASSERT(!mRoot.is_null(), "JSON document from %s is null", name.toUtf8().c_str());
-	ASSERT(mRoot.is_object(), "JSON document from %s is not an object. Read: \n%s", name.toUtf8().c_str(), data);
-	free(data);
 	WZ_PHYSFS_enumerateFolders("diffs", [&](const char *i) -> bool {
 		std::string str(std::string("diffs/") + i + std::string("/") + name.toUtf8().c_str());
 		if (!PHYSFS_exists(str.c_str()))
@@ -150,6 +165,38 @@ WzConfig::WzConfig(const WzString &name, WzConfig::warning warning)
 	pCurrentObj = &mRoot;
 }
 
+static void wzConfigReleasePrefetched(void *pData)
+{
+	delete static_cast<nlohmann::json *>(pData);
+}
+
+void wzConfigPrefetch(const char *fileName)
+{
+	UDWORD size = 0;
+	char *data = nullptr;
+
+	if (!PHYSFS_exists(fileName) || !loadFile(fileName, &data, &size, false))
+	{
+		return; // the WzConfig will report it
+	}
+
+	nlohmann::json *root = new nlohmann::json();
+	try {
+		*root = nlohmann::json::parse(data, data + size);
+	}
+	catch (...) {
+		root->clear();
+	}
+	free(data);
+
+	if (!root->is_object())
+	{
+		delete root; // let the WzConfig parse it again and report what is wrong
+		return;
+	}
+	resStorePrefetched(fileName, root, wzConfigReleasePrefetched);
+}
+
 bool WzConfig::isAtDocumentRoot() const
 {
 	return pCurrentObj == &mRoot;
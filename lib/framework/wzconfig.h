@@ -167,6 +167,9 @@ public:
 	std::string compactStringRepresentation(const bool ensure_ascii = false) const;
 };
 
+/// Read and parse a JSON file ahead of a read-only WzConfig of it, from a resource prefetch thread (see RES_PREFETCH).
+void wzConfigPrefetch(const char *fileName);
+
 // Enable JSON support for custom types
 
 // WzString
@@ -57,6 +57,7 @@ static uint32_t gameQueueTime[MAX_GAMEQUEUE_SLOTS];
 static uint32_t gameQueueCheckTime[MAX_GAMEQUEUE_SLOTS];
 static uint32_t gameQueueCheckCrc[MAX_GAMEQUEUE_SLOTS];
 static bool     crcError = false;
+static GameTimeCrcStats crcStats;
 
 static uint32_t updateReadyTime = 0;
 static uint32_t updateWantedTime = 0;
@@ -120,6 +121,7 @@ void gameTimeInit(void)
 
 	// Don't let syncDebug from previous games cause a desynch dump at gameTime 102.
 	crcError = false;
+	crcStats = GameTimeCrcStats();
 	resetSyncDebug();
 }
 
@@ -441,6 +443,28 @@ bool gtimeShouldWaitForPlayer(unsigned player)
 	return shouldWaitForPlayerSlot(player);
 }
 
+uint16_t gtimeGetChosenLatency()
+{
+	return discreteChosenLatency;
+}
+
+uint16_t gtimeGetWantedLatency(unsigned player)
+{
+	ASSERT_OR_RETURN(0, player < MAX_GAMEQUEUE_SLOTS, "Unexpected player: %u", player);
+	return wantedLatencies[player];
+}
+
+int32_t gtimeGetPlayerQueueLead(unsigned player)
+{
+	ASSERT_OR_RETURN(0, player < MAX_GAMEQUEUE_SLOTS, "Unexpected player: %u", player);
+	return static_cast<int32_t>(gameQueueTime[player] - gameTime);
+}
+
+GameTimeCrcStats gtimeGetCrcStats()
+{
+	return crcStats;
+}
+
 static inline bool shouldCheckDebugSyncForPlayerSlot(unsigned player)
 {
 	return NetPlay.players[player].allocated	// human player
@@ -471,8 +495,13 @@ void recvPlayerGameTime(NETQUEUE queue)
 	if (shouldCheckDebugSyncForPlayerSlot(queue.index))
 	{
 		syncDebug("GAME_GAME_TIME p%d;lat%u,ct%u,crc%04X,wlat%u", queue.index, latencyTicks, checkTime, checkCrc, wantedLatencies[queue.index]);
+		++crcStats.checked;
 		if (!checkDebugSync(checkTime, checkCrc))
 		{
+			if (crcStats.mismatched++ == 0)
+			{
+				crcStats.firstMismatchGameTime = checkTime;
+			}
 			debug(LOG_ERROR, "Found CRC error when receiving GAME_GAME_TIME for player: %" PRIu8 " (checkTime: %" PRIu32 ", checkCrc: %" PRIu16 ")", queue.index, checkTime, checkCrc);
 			crcError = true;
 			if (NetPlay.players[queue.index].allocated)
@@ -205,4 +205,16 @@ void setPlayerGameTime(unsigned player, uint32_t time);   ///< Sets the player's
 
 bool gtimeShouldWaitForPlayer(unsigned player);
 
+uint16_t gtimeGetChosenLatency();                         ///< The agreed-on latency (in milliseconds of game time) currently applied to game messages.
+uint16_t gtimeGetWantedLatency(unsigned player);          ///< The latency (in milliseconds of game time) the player last asked for in a GAME_GAME_TIME message.
+int32_t gtimeGetPlayerQueueLead(unsigned player);         ///< How far ahead of gameTime (in milliseconds of game time) we have received game messages from the player. Negative if we are waiting for them.
+
+struct GameTimeCrcStats
+{
+	uint32_t checked = 0;                                 ///< Number of GAME_GAME_TIME CRCs compared against our own sync log.
+	uint32_t mismatched = 0;                              ///< Number of those that did not match (or could not be checked).
+	uint32_t firstMismatchGameTime = 0;                   ///< checkTime of the first mismatch, if any.
+};
+GameTimeCrcStats gtimeGetCrcStats();                      ///< Since gameTimeInit().
+
 #endif
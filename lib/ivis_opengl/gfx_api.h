@@ -663,6 +663,10 @@ namespace gfx_api
 	constexpr std::size_t instance_Colour = 10;
 	constexpr std::size_t instance_TeamColour = 11;
 
+	// for instanced text (glyph atlas) rendering
+	constexpr std::size_t instance_glyphRect = 5;
+	constexpr std::size_t instance_glyphUV = 6;
+
 	using notexture = std::tuple<>;
 
 	// NOTE: Be very careful changing these constant_buffer_type structs;
@@ -1227,6 +1231,38 @@ namespace gfx_api
 	>,
 	std::tuple<texture_description<0, sampler_type::bilinear>>, SHADER_TEXT>;
 
+	template<>
+	struct constant_buffer_type<SHADER_TEXT_INSTANCED>
+	{
+		glm::mat4 transform_matrix;
+		glm::vec4 color;
+	};
+
+	// interleaved vertex data (one instance per glyph quad)
+	struct TextGlyphPerInstanceInterleavedData
+	{
+		TextGlyphPerInstanceInterleavedData(const glm::vec4 &rect, const glm::vec4 &uv)
+		: rect(rect), uv(uv)
+		{ }
+
+		glm::vec4 rect; // vec2 (position), vec2 (size) - in text (pixel) space
+		glm::vec4 uv; // vec2 (offset), vec2 (scale) - in atlas texture space
+	};
+	static_assert(sizeof(TextGlyphPerInstanceInterleavedData) % 16 == 0, "Size must be a multiple of 16");
+	static_assert(offsetof(TextGlyphPerInstanceInterleavedData, uv) == 16, "Unexpected offset");
+
+	using DrawImageTextPSO_Instanced = typename gfx_api::pipeline_state_helper<rasterizer_state<REND_TEXT, DEPTH_CMP_ALWAYS_WRT_OFF, 255, polygon_offset::disabled, stencil_mode::stencil_disabled, cull_mode::none>, primitive_type::triangle_strip, index_type::u16,
+	std::tuple<constant_buffer_type<SHADER_TEXT_INSTANCED>>,
+	std::tuple<
+	vertex_buffer_description<4, gfx_api::vertex_attribute_input_rate::vertex, vertex_attribute_description<position, gfx_api::vertex_attribute_type::u8x4_norm, 0>>,
+	// instance data
+	vertex_buffer_description<sizeof(TextGlyphPerInstanceInterleavedData), gfx_api::vertex_attribute_input_rate::instance,
+		vertex_attribute_description<instance_glyphRect, gfx_api::vertex_attribute_type::float4, offsetof(TextGlyphPerInstanceInterleavedData, rect)>,
+		vertex_attribute_description<instance_glyphUV, gfx_api::vertex_attribute_type::float4, offsetof(TextGlyphPerInstanceInterleavedData, uv)>
+		>
+	>,
+	std::tuple<texture_description<0, sampler_type::bilinear>>, SHADER_TEXT_INSTANCED>;
+
 	template<>
 	struct constant_buffer_type<SHADER_RECT>
 	{
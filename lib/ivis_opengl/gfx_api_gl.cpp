@@ -117,10 +117,16 @@ static std::unordered_set<const gl_texture*> debugLiveTextures;
 PFNGLDRAWARRAYSINSTANCEDPROC wz_dyn_glDrawArraysInstanced = nullptr;
 PFNGLDRAWELEMENTSINSTANCEDPROC wz_dyn_glDrawElementsInstanced = nullptr;
 PFNGLVERTEXATTRIBDIVISORPROC wz_dyn_glVertexAttribDivisor = nullptr;
+PFNGLGETPROGRAMBINARYPROC wz_dyn_glGetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC wz_dyn_glProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC wz_dyn_glProgramParameteri = nullptr;
 #else
 #define wz_dyn_glDrawArraysInstanced glDrawArraysInstanced
 #define wz_dyn_glDrawElementsInstanced glDrawElementsInstanced
 #define wz_dyn_glVertexAttribDivisor glVertexAttribDivisor
+#define wz_dyn_glGetProgramBinary glGetProgramBinary
+#define wz_dyn_glProgramBinary glProgramBinary
+#define wz_dyn_glProgramParameteri glProgramParameteri
 #endif
 
 static const GLubyte* wzSafeGlGetString(GLenum name);
@@ -929,6 +935,8 @@ static const std::map<SHADER_MODE, program_data> shader_to_file_table =
 	std::make_pair(SHADER_LINE, program_data{ "line program", "shaders/line.vert", "shaders/rect.frag",{ "from", "to", "color", "ModelViewProjectionMatrix" } }),
 	std::make_pair(SHADER_TEXT, program_data{ "Text program", "shaders/rect.vert", "shaders/text.frag",
 		{ "transformationMatrix", "tuv_offset", "tuv_scale", "color" } }),
+	std::make_pair(SHADER_TEXT_INSTANCED, program_data{ "Instanced text program", "shaders/text_instanced.vert", "shaders/text.frag",
+		{ "transformationMatrix", "color" } }),
 	std::make_pair(SHADER_DEBUG_TEXTURE2D_QUAD, program_data{ "Debug texture quad program", "shaders/quad_texture2d.vert", "shaders/quad_texture2d.frag",
 		{ "transformationMatrix", "uvTransformMatrix", "swizzle", "color", "texture" } }),
 	std::make_pair(SHADER_DEBUG_TEXTURE2DARRAY_QUAD, program_data{ "Debug texture array quad program", "shaders/quad_texture2darray.vert", "shaders/quad_texture2darray.frag",
@@ -1149,7 +1157,7 @@ typename std::pair<std::type_index, std::function<void(const void*, size_t)>>gl_
 	});
 }
 
-gl_pipeline_state_object::gl_pipeline_state_object(bool gles, bool fragmentHighpFloatAvailable, bool fragmentHighpIntAvailable, bool patchFragmentShaderMipLodBias, const gfx_api::pipeline_create_info& createInfo, optional<float> mipLodBias, const gfx_api::lighting_constants& shadowConstants) :
+gl_pipeline_state_object::gl_pipeline_state_object(bool gles, bool fragmentHighpFloatAvailable, bool fragmentHighpIntAvailable, bool patchFragmentShaderMipLodBias, const gfx_api::pipeline_create_info& createInfo, optional<float> mipLodBias, const gfx_api::lighting_constants& shadowConstants, const gfx_api::shader_binary_cache* programBinaryCache) :
 desc(createInfo.state_desc), vertex_buffer_desc(createInfo.attribute_descriptions)
 {
 	std::string vertexShaderHeader;
@@ -1197,7 +1205,7 @@ desc(createInfo.state_desc), vertex_buffer_desc(createInfo.attribute_description
 				  shader_to_file_table.at(createInfo.shader_mode).fragment_file,
 				  shader_to_file_table.at(createInfo.shader_mode).uniform_names,
 				  shader_to_file_table.at(createInfo.shader_mode).additional_samplers,
-				  mipLodBias, shadowConstants);
+				  mipLodBias, shadowConstants, programBinaryCache);
 
 	const std::unordered_map < std::type_index, std::function<void(const void*, size_t)>> uniforms_bind_table =
 	{
@@ -1224,6 +1232,7 @@ desc(createInfo.state_desc), vertex_buffer_desc(createInfo.attribute_description
 		uniform_binding_entry<SHADER_RECT_INSTANCED>(),
 		uniform_binding_entry<SHADER_LINE>(),
 		uniform_binding_entry<SHADER_TEXT>(),
+		uniform_binding_entry<SHADER_TEXT_INSTANCED>(),
 		uniform_binding_entry<SHADER_DEBUG_TEXTURE2D_QUAD>(),
 		uniform_binding_entry<SHADER_DEBUG_TEXTURE2DARRAY_QUAD>(),
 		uniform_binding_entry<SHADER_WORLD_TO_SCREEN>()
@@ -1709,7 +1718,8 @@ void gl_pipeline_state_object::build_program(bool fragmentHighpFloatAvailable, b
 											 const char * fragment_header, const std::string& fragmentPath,
 											 const std::vector<std::string> &uniformNames,
 											 const std::vector<std::tuple<std::string, GLint>> &samplersToBind,
-											 optional<float> mipLodBias, const gfx_api::lighting_constants& lightingConstants)
+											 optional<float> mipLodBias, const gfx_api::lighting_constants& lightingConstants,
+											 const gfx_api::shader_binary_cache* programBinaryCache)
 {
 	GLint status;
 	bool success = true; // Assume overall success
@@ -1742,6 +1752,9 @@ void gl_pipeline_state_object::build_program(bool fragmentHighpFloatAvailable, b
 	bindVertexAttribLocationIfUsed(program, gfx_api::instance_packedValues, "instancePackedValues");
 	bindVertexAttribLocationIfUsed(program, gfx_api::instance_Colour, "instanceColour");
 	bindVertexAttribLocationIfUsed(program, gfx_api::instance_TeamColour, "instanceTeamColour");
+	// only needed for instanced text rendering
+	bindVertexAttribLocationIfUsed(program, gfx_api::instance_glyphRect, "instanceGlyphRect");
+	bindVertexAttribLocationIfUsed(program, gfx_api::instance_glyphUV, "instanceGlyphUV");
 	ASSERT_OR_RETURN(, program, "Could not create shader program!");
 	// only needed for new terrain renderer
 	bindVertexAttribLocationIfUsed(program, gfx_api::terrain_tileNo, "tileNo");
@@ -1749,56 +1762,21 @@ void gl_pipeline_state_object::build_program(bool fragmentHighpFloatAvailable, b
 	bindVertexAttribLocationIfUsed(program, gfx_api::terrain_groundWeights, "groundWeights");
 
 	std::string vertexShaderContents;
+	std::string fragmentShaderStr;
+	std::vector<std::string> duplicateFragmentUniformNames;
 
 	if (!vertexPath.empty())
 	{
-		success = false; // Assume failure before reading shader file
-
 		vertexShaderContents = readShaderBuf(vertexPath);
-		if (!vertexShaderContents.empty())
-		{
-			GLuint shader = glCreateShader(GL_VERTEX_SHADER);
-			vertexShader = shader;
-
-			const char* ShaderStrings[2] = { vertex_header, vertexShaderContents.c_str() };
-
-			glShaderSource(shader, 2, ShaderStrings, nullptr);
-			glCompileShader(shader);
-
-			// Check for compilation errors
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-			if (!status)
-			{
-				debug(LOG_ERROR, "Vertex shader compilation has failed [%s]", vertexPath.c_str());
-				printShaderInfoLog(LOG_ERROR, shader);
-			}
-			else
-			{
-				printShaderInfoLog(LOG_3D, shader);
-				glAttachShader(program, shader);
-				success = true;
-			}
-#if defined(WZ_GL_KHR_DEBUG_SUPPORTED)
-			if ((/*GLEW_VERSION_4_3 ||*/ GLAD_GL_KHR_debug) && glObjectLabel)
-			{
-				glObjectLabel(GL_SHADER, shader, -1, vertexPath.c_str());
-			}
-#endif
-		}
+		success = !vertexShaderContents.empty();
 	}
 
-	std::vector<std::string> duplicateFragmentUniformNames;
-
 	if (success && !fragmentPath.empty())
 	{
-		success = false; // Assume failure before reading shader file
-
-		std::string fragmentShaderStr = readShaderBuf(fragmentPath);
-		if (!fragmentShaderStr.empty())
+		fragmentShaderStr = readShaderBuf(fragmentPath);
+		success = !fragmentShaderStr.empty();
+		if (success)
 		{
-			GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
-			fragmentShader = shader;
-
 			if (!fragmentHighpFloatAvailable || !fragmentHighpIntAvailable)
 			{
 				// rename duplicate uniforms
@@ -1832,49 +1810,126 @@ void gl_pipeline_state_object::build_program(bool fragmentHighpFloatAvailable, b
 			}
 			hasSpecializationConstant_ShadowConstants = patchFragmentShaderShadowConstants(fragmentShaderStr, lightingConstants);
 			hasSpecializationConstants_PointLights = patchFragmentShaderPointLightsDefines(fragmentShaderStr, lightingConstants);
+		}
+	}
 
-			const char* ShaderStrings[2] = { fragment_header, fragmentShaderStr.c_str() };
+	// The program binary cache is keyed on the final (patched) sources and the attribute bindings
+	bool loadedFromCache = false;
+	Sha256 programHash;
+	std::string programCacheEntryName;
+	if (success && programBinaryCache != nullptr)
+	{
+		std::vector<std::size_t> attribLocs(expectedVertexAttribLoc.begin(), expectedVertexAttribLoc.end());
+		std::sort(attribLocs.begin(), attribLocs.end());
 
-			glShaderSource(shader, 2, ShaderStrings, nullptr);
-			glCompileShader(shader);
+		gfx_api::shader_cache_hasher hasher;
+		hasher.add(programName).add(vertex_header).add(vertexShaderContents).add(fragment_header).add(fragmentShaderStr);
+		for (auto loc : attribLocs)
+		{
+			hasher.add_pod(static_cast<uint64_t>(loc));
+		}
+		programHash = hasher.result();
+		programCacheEntryName = programHash.toString();
+		loadedFromCache = load_program_binary(*programBinaryCache, programCacheEntryName, programHash);
+		if (loadedFromCache)
+		{
+			debug(LOG_3D, "Loaded cached program binary [%s]", programName.c_str());
+		}
+	}
 
-			// Check for compilation errors
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-			if (!status)
-			{
-				debug(LOG_ERROR, "Fragment shader compilation has failed [%s]", fragmentPath.c_str());
-				printShaderInfoLog(LOG_ERROR, shader);
-			}
-			else
-			{
-				printShaderInfoLog(LOG_3D, shader);
-				glAttachShader(program, shader);
-				success = true;
-			}
+	if (success && !loadedFromCache && !vertexPath.empty())
+	{
+		success = false; // Assume failure before compiling shader
+
+		GLuint shader = glCreateShader(GL_VERTEX_SHADER);
+		vertexShader = shader;
+
+		const char* ShaderStrings[2] = { vertex_header, vertexShaderContents.c_str() };
+
+		glShaderSource(shader, 2, ShaderStrings, nullptr);
+		glCompileShader(shader);
+
+		// Check for compilation errors
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if (!status)
+		{
+			debug(LOG_ERROR, "Vertex shader compilation has failed [%s]", vertexPath.c_str());
+			printShaderInfoLog(LOG_ERROR, shader);
+		}
+		else
+		{
+			printShaderInfoLog(LOG_3D, shader);
+			glAttachShader(program, shader);
+			success = true;
+		}
 #if defined(WZ_GL_KHR_DEBUG_SUPPORTED)
-			if ((/*GLEW_VERSION_4_3 ||*/ GLAD_GL_KHR_debug) && glObjectLabel)
-			{
-				glObjectLabel(GL_SHADER, shader, -1, fragmentPath.c_str());
-			}
-#endif
+		if ((/*GLEW_VERSION_4_3 ||*/ GLAD_GL_KHR_debug) && glObjectLabel)
+		{
+			glObjectLabel(GL_SHADER, shader, -1, vertexPath.c_str());
 		}
+#endif
 	}
 
-	if (success)
+	if (success && !loadedFromCache && !fragmentPath.empty())
 	{
-		glLinkProgram(program);
+		success = false; // Assume failure before compiling shader
+
+		GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
+		fragmentShader = shader;
+
+		const char* ShaderStrings[2] = { fragment_header, fragmentShaderStr.c_str() };
+
+		glShaderSource(shader, 2, ShaderStrings, nullptr);
+		glCompileShader(shader);
 
-		// Check for linkage errors
-		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		// Check for compilation errors
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
 		if (!status)
 		{
-			debug(LOG_ERROR, "Shader program linkage has failed [%s, %s]", vertexPath.c_str(), fragmentPath.c_str());
-			printProgramInfoLog(LOG_ERROR, program);
-			success = false;
+			debug(LOG_ERROR, "Fragment shader compilation has failed [%s]", fragmentPath.c_str());
+			printShaderInfoLog(LOG_ERROR, shader);
 		}
 		else
 		{
-			printProgramInfoLog(LOG_3D, program);
+			printShaderInfoLog(LOG_3D, shader);
+			glAttachShader(program, shader);
+			success = true;
+		}
+#if defined(WZ_GL_KHR_DEBUG_SUPPORTED)
+		if ((/*GLEW_VERSION_4_3 ||*/ GLAD_GL_KHR_debug) && glObjectLabel)
+		{
+			glObjectLabel(GL_SHADER, shader, -1, fragmentPath.c_str());
+		}
+#endif
+	}
+
+	if (success)
+	{
+		if (!loadedFromCache)
+		{
+			if (programBinaryCache != nullptr)
+			{
+				wz_dyn_glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+
+			glLinkProgram(program);
+
+			// Check for linkage errors
+			glGetProgramiv(program, GL_LINK_STATUS, &status);
+			if (!status)
+			{
+				debug(LOG_ERROR, "Shader program linkage has failed [%s, %s]", vertexPath.c_str(), fragmentPath.c_str());
+				printProgramInfoLog(LOG_ERROR, program);
+				success = false;
+			}
+			else
+			{
+				printProgramInfoLog(LOG_3D, program);
+				if (programBinaryCache != nullptr)
+				{
+					save_program_binary(*programBinaryCache, programCacheEntryName, programHash);
+				}
+			}
 		}
 #if defined(WZ_GL_KHR_DEBUG_SUPPORTED)
 		if ((/*GLEW_VERSION_4_3 ||*/ GLAD_GL_KHR_debug) && glObjectLabel)
@@ -1888,6 +1943,48 @@ void gl_pipeline_state_object::build_program(bool fragmentHighpFloatAvailable, b
 	broken |= !success;
 }
 
+bool gl_pipeline_state_object::load_program_binary(const gfx_api::shader_binary_cache& cache, const std::string& entryName, const Sha256& contentHash)
+{
+	optional<gfx_api::shader_binary_cache::entry> cached = cache.load(entryName, contentHash);
+	if (!cached.has_value() || cached->data.size() > static_cast<size_t>(std::numeric_limits<GLsizei>::max()))
+	{
+		return false;
+	}
+
+	wz_dyn_glProgramBinary(program, static_cast<GLenum>(cached->format), cached->data.data(), static_cast<GLsizei>(cached->data.size()));
+
+	// Drivers are free to reject a binary at any time (ex. after an update that didn't change the version strings)
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status)
+	{
+		debug(LOG_3D, "Cached program binary was rejected by the driver: %s", entryName.c_str());
+		wzGLClearErrors();
+		return false;
+	}
+	return true;
+}
+
+void gl_pipeline_state_object::save_program_binary(const gfx_api::shader_binary_cache& cache, const std::string& entryName, const Sha256& contentHash)
+{
+	GLint binaryLength = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	if (binaryLength <= 0)
+	{
+		return;
+	}
+
+	std::vector<uint8_t> binary(static_cast<size_t>(binaryLength));
+	GLsizei writtenLength = 0;
+	GLenum binaryFormat = 0;
+	wz_dyn_glGetProgramBinary(program, binaryLength, &writtenLength, &binaryFormat, binary.data());
+	if (writtenLength <= 0)
+	{
+		return;
+	}
+	cache.save(entryName, contentHash, static_cast<uint32_t>(binaryFormat), binary.data(), static_cast<size_t>(writtenLength));
+}
+
 void gl_pipeline_state_object::fetch_uniforms(const std::vector<std::string>& uniformNames, const std::vector<std::string>& duplicateFragmentUniformNames, const std::string& programName)
 {
 	std::transform(uniformNames.begin(), uniformNames.end(),
@@ -2357,6 +2454,12 @@ void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type
 	setUniforms(3, cbuf.color);
 }
 
+void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type<SHADER_TEXT_INSTANCED>& cbuf)
+{
+	setUniforms(0, cbuf.transform_matrix);
+	setUniforms(1, cbuf.color);
+}
+
 void gl_pipeline_state_object::set_constants(const gfx_api::constant_buffer_type<SHADER_DEBUG_TEXTURE2D_QUAD>& cbuf)
 {
 	setUniforms(0, cbuf.transform_matrix);
@@ -2590,7 +2693,7 @@ gfx_api::pipeline_state_object* gl_context::build_pipeline(gfx_api::pipeline_sta
 	}
 
 	bool patchFragmentShaderMipLodBias = true; // provide the constant to the shader directly
-	auto pipeline = new gl_pipeline_state_object(gles, fragmentHighpFloatAvailable, fragmentHighpIntAvailable, patchFragmentShaderMipLodBias, createInfo, mipLodBias, shadowConstants);
+	auto pipeline = new gl_pipeline_state_object(gles, fragmentHighpFloatAvailable, fragmentHighpIntAvailable, patchFragmentShaderMipLodBias, createInfo, mipLodBias, shadowConstants, programBinaryCache.get());
 	if (!psoID.has_value())
 	{
 		createdPipelines.emplace_back(createInfo);
@@ -3506,6 +3609,16 @@ bool gl_context::_initialize(const gfx_api::backend_Impl_Factory& impl, int32_t
 	initPixelFormatsSupport();
 	hasInstancedRenderingSupport = initInstancedFunctions();
 	debug(LOG_INFO, "  * Instanced rendering support %s detected", hasInstancedRenderingSupport ? "was" : "was NOT");
+	if (initProgramBinaryFunctions())
+	{
+		std::string driverIdentity = astringf("%s|%s|%s|%s", opengl.vendor, opengl.renderer, opengl.version, opengl.GLSLversion);
+		programBinaryCache = std::make_unique<gfx_api::shader_binary_cache>(gles ? "gles" : "gl", driverIdentity);
+		if (!programBinaryCache->enabled())
+		{
+			programBinaryCache.reset();
+		}
+	}
+	debug(LOG_INFO, "  * Program binary cache %s", programBinaryCache ? "enabled" : "NOT available");
 	hasBorderClampSupport = initCheckBorderClampSupport();
 
 	int width, height = 0;
@@ -4603,6 +4716,58 @@ bool gl_context::initInstancedFunctions()
 	return true;
 }
 
+bool gl_context::initProgramBinaryFunctions()
+{
+#if !defined(WZ_STATIC_GL_BINDINGS)
+	wz_dyn_glGetProgramBinary = nullptr;
+	wz_dyn_glProgramBinary = nullptr;
+	wz_dyn_glProgramParameteri = nullptr;
+
+	if (!gles)
+	{
+		// Core in OpenGL 4.1 (or GL_ARB_get_program_binary), which is beyond what glad loads - so load it manually
+		GLint gl_majorversion = wz_GetGLIntegerv(GL_MAJOR_VERSION, 0);
+		GLint gl_minorversion = wz_GetGLIntegerv(GL_MINOR_VERSION, 0);
+		bool hasSupport = (gl_majorversion > 4) || (gl_majorversion == 4 && gl_minorversion >= 1);
+		if (!hasSupport)
+		{
+			std::vector<std::string> glExtensions = getGLExtensions();
+			hasSupport = std::find(glExtensions.begin(), glExtensions.end(), "GL_ARB_get_program_binary") != glExtensions.end();
+		}
+		GLADloadproc func_GLGetProcAddress = backend_impl->getGLGetProcAddress();
+		if (hasSupport && func_GLGetProcAddress)
+		{
+			wz_dyn_glGetProgramBinary = reinterpret_cast<PFNGLGETPROGRAMBINARYPROC>(func_GLGetProcAddress("glGetProgramBinary"));
+			wz_dyn_glProgramBinary = reinterpret_cast<PFNGLPROGRAMBINARYPROC>(func_GLGetProcAddress("glProgramBinary"));
+			wz_dyn_glProgramParameteri = reinterpret_cast<PFNGLPROGRAMPARAMETERIPROC>(func_GLGetProcAddress("glProgramParameteri"));
+		}
+	}
+	else
+	{
+		if (GLAD_GL_ES_VERSION_3_0)
+		{
+			wz_dyn_glGetProgramBinary = glGetProgramBinary;
+			wz_dyn_glProgramBinary = glProgramBinary;
+			wz_dyn_glProgramParameteri = glProgramParameteri;
+		}
+	}
+
+	// Some drivers expose the functions but don't support any binary formats
+	if (!wz_dyn_glGetProgramBinary || !wz_dyn_glProgramBinary || !wz_dyn_glProgramParameteri
+		|| wz_GetGLIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, 0) <= 0)
+	{
+		wz_dyn_glGetProgramBinary = nullptr;
+		wz_dyn_glProgramBinary = nullptr;
+		wz_dyn_glProgramParameteri = nullptr;
+		return false;
+	}
+	return true;
+#else
+	// WebGL does not support program binaries
+	return false;
+#endif
+}
+
 bool gl_context::initCheckBorderClampSupport()
 {
 	// GL_CLAMP_TO_BORDER is supported on:
@@ -4681,6 +4846,7 @@ void gl_context::shutdown()
 	}
 
 	deleteSceneRenderpass();
+	programBinaryCache.reset();
 
 #if !defined(WZ_STATIC_GL_BINDINGS)
 	if (glDeleteFramebuffers)
@@ -4864,7 +5030,7 @@ bool gl_context::setShadowConstants(gfx_api::lighting_constants newValues)
 			(pipelineInfo.pso->hasSpecializationConstant_ShadowConstants || pipelineInfo.pso->hasSpecializationConstants_PointLights))
 		{
 			delete pipelineInfo.pso;
-			pipelineInfo.pso = new gl_pipeline_state_object(gles, fragmentHighpFloatAvailable, fragmentHighpIntAvailable, patchFragmentShaderMipLodBias, pipelineInfo.createInfo, mipLodBias, shadowConstants);
+			pipelineInfo.pso = new gl_pipeline_state_object(gles, fragmentHighpFloatAvailable, fragmentHighpIntAvailable, patchFragmentShaderMipLodBias, pipelineInfo.createInfo, mipLodBias, shadowConstants, programBinaryCache.get());
 		}
 	}
 
@@ -4879,7 +5045,7 @@ bool gl_context::debugRecompileAllPipelines()
 		if (pipelineInfo.pso)
 		{
 			delete pipelineInfo.pso;
-			pipelineInfo.pso = new gl_pipeline_state_object(gles, fragmentHighpFloatAvailable, fragmentHighpIntAvailable, patchFragmentShaderMipLodBias, pipelineInfo.createInfo, mipLodBias, shadowConstants);
+			pipelineInfo.pso = new gl_pipeline_state_object(gles, fragmentHighpFloatAvailable, fragmentHighpIntAvailable, patchFragmentShaderMipLodBias, pipelineInfo.createInfo, mipLodBias, shadowConstants, programBinaryCache.get());
 		}
 	}
 	return true;
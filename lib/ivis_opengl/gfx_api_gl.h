@@ -20,6 +20,7 @@
 #pragma once
 
 #include "gfx_api.h"
+#include "gfx_api_shadercache.h"
 
 #if defined(__EMSCRIPTEN__)
 # define WZ_STATIC_GL_BINDINGS
@@ -195,7 +196,7 @@ struct gl_pipeline_state_object final : public gfx_api::pipeline_state_object
 	template<typename T>
 	typename std::pair<std::type_index, std::function<void(const void*, size_t)>> uniform_setting_func();
 
-	gl_pipeline_state_object(bool gles, bool fragmentHighpFloatAvailable, bool fragmentHighpIntAvailable, bool patchFragmentShaderMipLodBias, const gfx_api::pipeline_create_info& createInfo, optional<float> mipLodBias, const gfx_api::lighting_constants& shadowConstants);
+	gl_pipeline_state_object(bool gles, bool fragmentHighpFloatAvailable, bool fragmentHighpIntAvailable, bool patchFragmentShaderMipLodBias, const gfx_api::pipeline_create_info& createInfo, optional<float> mipLodBias, const gfx_api::lighting_constants& shadowConstants, const gfx_api::shader_binary_cache* programBinaryCache);
 	~gl_pipeline_state_object();
 	void set_constants(const void* buffer, const size_t& size);
 	void set_uniforms(const size_t& first, const std::vector<std::tuple<const void*, size_t>>& uniform_blocks);
@@ -222,7 +223,12 @@ private:
 					   const char * fragment_header, const std::string& fragmentPath,
 					   const std::vector<std::string> &uniformNames,
 					   const std::vector<std::tuple<std::string, GLint>> &samplersToBind,
-					   optional<float> mipLodBias, const gfx_api::lighting_constants& shadowConstants);
+					   optional<float> mipLodBias, const gfx_api::lighting_constants& shadowConstants,
+					   const gfx_api::shader_binary_cache* programBinaryCache);
+
+	// Try to load a previously-linked program binary (returns true if the program is linked and ready to use)
+	bool load_program_binary(const gfx_api::shader_binary_cache& cache, const std::string& entryName, const Sha256& contentHash);
+	void save_program_binary(const gfx_api::shader_binary_cache& cache, const std::string& entryName, const Sha256& contentHash);
 
 	void fetch_uniforms(const std::vector<std::string>& uniformNames, const std::vector<std::string>& duplicateFragmentUniforms, const std::string& programName);
 
@@ -274,6 +280,7 @@ private:
 	void set_constants(const gfx_api::constant_buffer_type<SHADER_RECT_INSTANCED>& cbuf);
 	void set_constants(const gfx_api::constant_buffer_type<SHADER_LINE>& cbuf);
 	void set_constants(const gfx_api::constant_buffer_type<SHADER_TEXT>& cbuf);
+	void set_constants(const gfx_api::constant_buffer_type<SHADER_TEXT_INSTANCED>& cbuf);
 	void set_constants(const gfx_api::constant_buffer_type<SHADER_DEBUG_TEXTURE2D_QUAD>& cbuf);
 	void set_constants(const gfx_api::constant_buffer_type<SHADER_DEBUG_TEXTURE2DARRAY_QUAD>& cbuf);
 	void set_constants(const gfx_api::constant_buffer_type<SHADER_WORLD_TO_SCREEN>& cbuf);
@@ -294,6 +301,9 @@ struct gl_context final : public gfx_api::context
 	bool fragmentHighpFloatAvailable = true;
 	bool fragmentHighpIntAvailable = true;
 
+	// on-disk cache of linked program binaries (only if supported by the driver)
+	std::unique_ptr<gfx_api::shader_binary_cache> programBinaryCache;
+
 	gl_context(bool _debug) : khr_debug(_debug) {}
 	~gl_context();
 
@@ -367,6 +377,7 @@ private:
 	virtual bool _initialize(const gfx_api::backend_Impl_Factory& impl, int32_t antialiasing, swap_interval_mode mode, optional<float> mipLodBias, uint32_t depthMapResolution) override;
 	void initPixelFormatsSupport();
 	bool initInstancedFunctions();
+	bool initProgramBinaryFunctions();
 	bool initCheckBorderClampSupport();
 	size_t initDepthPasses(size_t resolution);
 	gl_gpurendered_texture* create_gpurendered_texture(GLenum internalFormat, GLenum format, GLenum type, const size_t& width, const size_t& height, const std::string& filename);
@@ -0,0 +1,181 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2024  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "gfx_api_shadercache.h"
+
+#include "lib/framework/frame.h"
+#include "lib/framework/file.h"
+#include "lib/framework/physfs_ext.h"
+
+#include <cstring>
+
+#define WZ_SHADER_CACHE_ROOT_DIR "cache/shaders"
+
+// Bump whenever the file layout below changes
+static const uint32_t WZ_SHADER_CACHE_VERSION = 1;
+static const char WZ_SHADER_CACHE_MAGIC[4] = {'W', 'Z', 'S', 'C'};
+
+// File layout (host byte order - the cache is never shared between machines):
+//   magic[4] | version (u32) | format (u32) | driverHash[32] | contentHash[32] | dataHash[32] | dataSize (u64) | data
+struct ShaderCacheFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t format;
+	uint8_t driverHash[Sha256::Bytes];
+	uint8_t contentHash[Sha256::Bytes];
+	uint8_t dataHash[Sha256::Bytes];
+	uint64_t dataSize;
+};
+
+namespace gfx_api
+{
+
+shader_cache_hasher& shader_cache_hasher::add(const void* data, size_t dataSize)
+{
+	Sha256 pieceHash = sha256Sum(data, dataSize);
+	uint8_t combined[Sha256::Bytes * 2 + sizeof(uint64_t)];
+	uint64_t size64 = static_cast<uint64_t>(dataSize);
+	memcpy(combined, m_state.bytes, Sha256::Bytes);
+	memcpy(combined + Sha256::Bytes, pieceHash.bytes, Sha256::Bytes);
+	memcpy(combined + Sha256::Bytes * 2, &size64, sizeof(uint64_t));
+	m_state = sha256Sum(combined, sizeof(combined));
+	return *this;
+}
+
+shader_cache_hasher& shader_cache_hasher::add(const std::string& str)
+{
+	return add(str.data(), str.size());
+}
+
+shader_binary_cache::shader_binary_cache(const std::string& backendName, const std::string& driverIdentity)
+	: m_dir(std::string(WZ_SHADER_CACHE_ROOT_DIR) + "/" + backendName)
+{
+	m_driverHash = sha256Sum(driverIdentity.data(), driverIdentity.size());
+	if (PHYSFS_getWriteDir() == nullptr)
+	{
+		debug(LOG_3D, "No write dir - shader cache disabled");
+		return;
+	}
+	if (!PHYSFS_exists(m_dir.c_str()) && PHYSFS_mkdir(m_dir.c_str()) == 0)
+	{
+		debug(LOG_WARNING, "Unable to create shader cache dir: %s (%s)", m_dir.c_str(), WZ_PHYSFS_getLastError());
+		return;
+	}
+	m_enabled = true;
+}
+
+std::string shader_binary_cache::entryPath(const std::string& entryName) const
+{
+	return m_dir + "/" + entryName + ".bin";
+}
+
+optional<shader_binary_cache::entry> shader_binary_cache::load(const std::string& entryName, const Sha256& contentHash) const
+{
+	if (!m_enabled)
+	{
+		return nullopt;
+	}
+	std::string path = entryPath(entryName);
+	if (!PHYSFS_exists(path.c_str()))
+	{
+		return nullopt;
+	}
+	std::vector<char> fileData;
+	if (!loadFileToBufferVector(path.c_str(), fileData, false, false))
+	{
+		return nullopt;
+	}
+	ShaderCacheFileHeader header;
+	if (fileData.size() < sizeof(header))
+	{
+		debug(LOG_3D, "Ignoring truncated shader cache entry: %s", path.c_str());
+		return nullopt;
+	}
+	memcpy(&header, fileData.data(), sizeof(header));
+	if (memcmp(header.magic, WZ_SHADER_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != WZ_SHADER_CACHE_VERSION)
+	{
+		debug(LOG_3D, "Ignoring shader cache entry with unknown format: %s", path.c_str());
+		return nullopt;
+	}
+	if (memcmp(header.driverHash, m_driverHash.bytes, Sha256::Bytes) != 0)
+	{
+		debug(LOG_3D, "Ignoring shader cache entry from a different driver: %s", path.c_str());
+		return nullopt;
+	}
+	if (memcmp(header.contentHash, contentHash.bytes, Sha256::Bytes) != 0)
+	{
+		debug(LOG_3D, "Ignoring stale shader cache entry: %s", path.c_str());
+		return nullopt;
+	}
+	if (header.dataSize != static_cast<uint64_t>(fileData.size() - sizeof(header)))
+	{
+		debug(LOG_3D, "Ignoring truncated shader cache entry: %s", path.c_str());
+		return nullopt;
+	}
+	const char* pData = fileData.data() + sizeof(header);
+	Sha256 dataHash = sha256Sum(pData, static_cast<size_t>(header.dataSize));
+	if (memcmp(header.dataHash, dataHash.bytes, Sha256::Bytes) != 0)
+	{
+		debug(LOG_3D, "Ignoring corrupt shader cache entry: %s", path.c_str());
+		return nullopt;
+	}
+
+	entry result;
+	result.format = header.format;
+	result.data.assign(pData, pData + header.dataSize);
+	return result;
+}
+
+bool shader_binary_cache::save(const std::string& entryName, const Sha256& contentHash, uint32_t format, const void* data, size_t dataSize) const
+{
+	if (!m_enabled || data == nullptr || dataSize == 0)
+	{
+		return false;
+	}
+
+	ShaderCacheFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, WZ_SHADER_CACHE_MAGIC, sizeof(header.magic));
+	header.version = WZ_SHADER_CACHE_VERSION;
+	header.format = format;
+	memcpy(header.driverHash, m_driverHash.bytes, Sha256::Bytes);
+	memcpy(header.contentHash, contentHash.bytes, Sha256::Bytes);
+	Sha256 dataHash = sha256Sum(data, dataSize);
+	memcpy(header.dataHash, dataHash.bytes, Sha256::Bytes);
+	header.dataSize = static_cast<uint64_t>(dataSize);
+
+	std::string path = entryPath(entryName);
+	PHYSFS_file* fileHandle = openSaveFile(path.c_str());
+	if (!fileHandle)
+	{
+		return false;
+	}
+	bool success = WZ_PHYSFS_writeBytes(fileHandle, &header, sizeof(header)) == static_cast<PHYSFS_sint64>(sizeof(header))
+		&& WZ_PHYSFS_writeBytes(fileHandle, data, static_cast<PHYSFS_uint32>(dataSize)) == static_cast<PHYSFS_sint64>(dataSize);
+	PHYSFS_close(fileHandle);
+	if (!success)
+	{
+		debug(LOG_WARNING, "Failed to write shader cache entry: %s", path.c_str());
+		PHYSFS_delete(path.c_str());
+	}
+	return success;
+}
+
+} // namespace gfx_api
@@ -0,0 +1,79 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2024  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#include "lib/framework/crc.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <nonstd/optional.hpp>
+using nonstd::optional;
+using nonstd::nullopt;
+
+namespace gfx_api
+{
+	// On-disk cache for driver-compiled shader / pipeline data, stored under "cache/shaders/<backend>" in the write dir.
+	//
+	// Every entry is stamped with a hash of the driver identity (vendor, device, driver version, ...) and a hash of
+	// the inputs it was built from (shader sources / SPIR-V). Entries that don't match both (or fail their integrity
+	// check) are ignored, so a driver or game update simply causes a rebuild.
+	class shader_binary_cache
+	{
+	public:
+		struct entry
+		{
+			uint32_t format = 0; // backend-specific (ex. the GL program binary format)
+			std::vector<uint8_t> data;
+		};
+
+	public:
+		shader_binary_cache(const std::string& backendName, const std::string& driverIdentity);
+
+		bool enabled() const { return m_enabled; }
+
+		optional<entry> load(const std::string& entryName, const Sha256& contentHash) const;
+		bool save(const std::string& entryName, const Sha256& contentHash, uint32_t format, const void* data, size_t dataSize) const;
+
+	private:
+		std::string entryPath(const std::string& entryName) const;
+
+	private:
+		std::string m_dir;
+		Sha256 m_driverHash;
+		bool m_enabled = false;
+	};
+
+	// Builds a content hash out of multiple pieces (each piece is hashed separately and folded into the running hash)
+	class shader_cache_hasher
+	{
+	public:
+		shader_cache_hasher& add(const void* data, size_t dataSize);
+		shader_cache_hasher& add(const std::string& str);
+		template <typename T>
+		shader_cache_hasher& add_pod(const T& value) { return add(&value, sizeof(T)); }
+
+		const Sha256& result() const { return m_state; }
+
+	private:
+		Sha256 m_state;
+	};
+}
@@ -41,6 +41,7 @@
 
 #include "gfx_api_vk.h"
 #include "lib/framework/physfs_ext.h"
+#include "lib/framework/file.h"
 #include "lib/framework/wzapp.h"
 #include "lib/exceptionhandler/dumpinfo.h"
 
@@ -1175,6 +1176,7 @@ static const std::map<SHADER_MODE, shader_infos> spv_files
 	std::make_pair(SHADER_GENERIC_COLOR, shader_infos{ "shaders/vk/generic.vert.spv", "shaders/vk/rect.frag.spv" }),
 	std::make_pair(SHADER_LINE, shader_infos{ "shaders/vk/line.vert.spv", "shaders/vk/rect.frag.spv" }),
 	std::make_pair(SHADER_TEXT, shader_infos{ "shaders/vk/rect.vert.spv", "shaders/vk/text.frag.spv" }),
+	std::make_pair(SHADER_TEXT_INSTANCED, shader_infos{ "shaders/vk/text_instanced.vert.spv", "shaders/vk/text_instanced.frag.spv" }),
 	std::make_pair(SHADER_WORLD_TO_SCREEN, shader_infos{ "shaders/vk/world_to_screen.vert.spv", "shaders/vk/world_to_screen.frag.spv" }),
 	std::make_pair(SHADER_DEBUG_TEXTURE2D_QUAD, shader_infos{ "shaders/vk/quad_texture2d.vert.spv", "shaders/vk/quad_texture2d.frag.spv" }),
 	std::make_pair(SHADER_DEBUG_TEXTURE2DARRAY_QUAD, shader_infos{ "shaders/vk/quad_texture2darray.vert.spv", "shaders/vk/quad_texture2darray.frag.spv" })
@@ -1800,7 +1802,7 @@ VkPSO::VkPSO(vk::Device _dev,
 		.setPMultisampleState(&multisampleState)
 		.setRenderPass(rp);
 
-	vk::ResultValue<vk::Pipeline> result = dev.createGraphicsPipeline(vk::PipelineCache(), pso, nullptr, *pVkDynLoader);
+	vk::ResultValue<vk::Pipeline> result = dev.createGraphicsPipeline(root->pipelineCache, pso, nullptr, *pVkDynLoader);
 	switch (result.result)
 	{
 		case vk::Result::eSuccess:
@@ -3650,6 +3652,8 @@ void VkRoot::shutdown()
 	}
 	createdPipelines.clear();
 
+	destroyPipelineCache();
+
 	// destroy depth pass objects
 	for (auto f : renderPasses[DEPTH_RENDER_PASS_ID].fbo)
 	{
@@ -4744,6 +4748,8 @@ bool VkRoot::_initialize(const gfx_api::backend_Impl_Factory& impl, int32_t anti
 
 	getQueues();
 
+	createPipelineCache();
+
 	ASSERT(renderPasses.empty(), "Non-empty renderPasses vector?");
 	renderPasses = { RenderPassDetails(DEFAULT_RENDER_PASS_ID), RenderPassDetails(DEPTH_RENDER_PASS_ID), RenderPassDetails(SCENE_RENDER_PASS_ID) };
 
@@ -5089,6 +5095,110 @@ bool VkRoot::createAllocator()
 	return result == VK_SUCCESS;
 }
 
+#define WZ_VK_PIPELINE_CACHE_ENTRY "pipelines"
+
+static std::string vkPipelineCacheDriverIdentity(const vk::PhysicalDeviceProperties& props)
+{
+	std::string identity = astringf("%u:%u:%u:%u:", props.vendorID, props.deviceID, props.driverVersion, props.apiVersion);
+	for (size_t i = 0; i < VK_UUID_SIZE; ++i)
+	{
+		identity += astringf("%02x", static_cast<unsigned>(props.pipelineCacheUUID[i]));
+	}
+	identity += ":";
+	identity += static_cast<const char*>(props.deviceName);
+	return identity;
+}
+
+// Hash of every SPIR-V module the pipelines may be built from (so a shader change invalidates the cache)
+static Sha256 vkPipelineCacheContentHash()
+{
+	std::set<std::string> shaderFiles;
+	for (const auto& shaderInfo : spv_files)
+	{
+		shaderFiles.insert(shaderInfo.second.vertexSpv);
+		shaderFiles.insert(shaderInfo.second.fragmentSpv);
+	}
+	gfx_api::shader_cache_hasher hasher;
+	hasher.add_pod(VK_HEADER_VERSION);
+	for (const auto& shaderFile : shaderFiles)
+	{
+		hasher.add(shaderFile);
+		std::vector<char> fileData;
+		if (PHYSFS_exists(shaderFile.c_str()) && loadFileToBufferVector(shaderFile.c_str(), fileData, false, false))
+		{
+			hasher.add(fileData.data(), fileData.size());
+		}
+	}
+	return hasher.result();
+}
+
+void VkRoot::createPipelineCache()
+{
+	ASSERT_OR_RETURN(, dev, "Logical device is null");
+	ASSERT_OR_RETURN(, !pipelineCache, "Pipeline cache already exists");
+
+	pipelineCacheStorage = std::make_unique<gfx_api::shader_binary_cache>("vk", vkPipelineCacheDriverIdentity(physDeviceProps));
+	pipelineCacheContentHash = vkPipelineCacheContentHash();
+
+	optional<gfx_api::shader_binary_cache::entry> cachedData = pipelineCacheStorage->load(WZ_VK_PIPELINE_CACHE_ENTRY, pipelineCacheContentHash);
+	vk::PipelineCacheCreateInfo createInfo;
+	if (cachedData.has_value())
+	{
+		createInfo.setInitialDataSize(cachedData->data.size());
+		createInfo.setPInitialData(cachedData->data.data());
+	}
+
+	try
+	{
+		pipelineCache = dev.createPipelineCache(createInfo, nullptr, vkDynLoader);
+		debug(LOG_3D, "Created pipeline cache (initial data: %zu bytes)", static_cast<size_t>(createInfo.initialDataSize));
+	}
+	catch (const vk::SystemError& e)
+	{
+		debug(LOG_3D, "createPipelineCache failed: %s", e.what());
+		pipelineCache = vk::PipelineCache();
+		if (cachedData.has_value())
+		{
+			// retry without the (possibly rejected) initial data
+			try
+			{
+				pipelineCache = dev.createPipelineCache(vk::PipelineCacheCreateInfo(), nullptr, vkDynLoader);
+			}
+			catch (const vk::SystemError& e2)
+			{
+				debug(LOG_3D, "createPipelineCache failed: %s", e2.what());
+				pipelineCache = vk::PipelineCache();
+			}
+		}
+	}
+}
+
+void VkRoot::destroyPipelineCache()
+{
+	if (!pipelineCache)
+	{
+		return;
+	}
+	if (pipelineCacheStorage)
+	{
+		try
+		{
+			std::vector<uint8_t> cacheData = dev.getPipelineCacheData(pipelineCache, vkDynLoader);
+			if (!cacheData.empty())
+			{
+				pipelineCacheStorage->save(WZ_VK_PIPELINE_CACHE_ENTRY, pipelineCacheContentHash, 0, cacheData.data(), cacheData.size());
+			}
+		}
+		catch (const vk::SystemError& e)
+		{
+			debug(LOG_3D, "getPipelineCacheData failed: %s", e.what());
+		}
+	}
+	dev.destroyPipelineCache(pipelineCache, nullptr, vkDynLoader);
+	pipelineCache = vk::PipelineCache();
+	pipelineCacheStorage.reset();
+}
+
 void VkRoot::getQueues()
 {
 	ASSERT(queueFamilyIndices.isComplete(), "Did not receive complete indices from findQueueFamilies");
@@ -48,6 +48,7 @@
 #include "lib/framework/frame.h"
 
 #include "gfx_api.h"
+#include "gfx_api_shadercache.h"
 #include <algorithm>
 #include <sstream>
 #include <map>
@@ -648,6 +649,11 @@ struct VkRoot final : gfx_api::context
 	// allocator
 	VmaAllocator allocator = VK_NULL_HANDLE;
 
+	// pipeline cache (persisted to disk between runs)
+	vk::PipelineCache pipelineCache;
+	std::unique_ptr<gfx_api::shader_binary_cache> pipelineCacheStorage;
+	Sha256 pipelineCacheContentHash;
+
 	// swapchain
 	vk::PresentModeKHR presentMode = vk::PresentModeKHR::eFifo;
 	vk::Extent2D swapchainSize;
@@ -784,6 +790,8 @@ private:
 	void getQueueFamiliesInfo();
 	bool createLogicalDevice();
 	bool createAllocator();
+	void createPipelineCache();
+	void destroyPipelineCache();
 	void getQueues();
 	bool createSwapchain(bool allowHandleSurfaceLost = true);
 	void rebuildPipelinesIfNecessary();
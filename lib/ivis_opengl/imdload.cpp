@@ -28,6 +28,8 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <array>
+#include <algorithm>
+#include <type_traits>
 
 #include "lib/framework/frame.h"
 #include "lib/framework/string_ext.h"
@@ -35,6 +37,7 @@
 #include "lib/framework/fixedpoint.h"
 #include "lib/framework/file.h"
 #include "lib/framework/physfs_ext.h"
+#include "lib/framework/crc.h"
 #include "lib/ivis_opengl/piematrix.h"
 #include "lib/ivis_opengl/pienormalize.h"
 #include "lib/ivis_opengl/piestate.h"
@@ -56,7 +59,18 @@ static size_t currentTilesetIdx = 0;
 static size_t modelLoadingErrors = 0;
 static size_t modelTextureLoadingFailures = 0;
 
-static std::unique_ptr<iIMDShape> iV_ProcessIMD(const WzString &filename, const char **ppFileData, const char *FileDataEnd, bool skipGPUData);
+/// The GPU buffer contents of one shape level, as kept in the model cache
+struct IMDLevelBuffers
+{
+	std::vector<gfx_api::gfxFloat> vertices;
+	std::vector<gfx_api::gfxFloat> normals;
+	std::vector<gfx_api::gfxFloat> texcoords; // texcoords + texAnim
+	std::vector<gfx_api::gfxFloat> tangents;
+	std::vector<uint16_t> indices;
+};
+
+static std::unique_ptr<iIMDShape> iV_ProcessIMD(const WzString &filename, const char **ppFileData, const char *FileDataEnd, bool skipGPUData, std::vector<IMDLevelBuffers> *cacheOut = nullptr);
+static std::unique_ptr<iIMDShape> iV_ProcessIMDCached(const WzString &filename, const char *pFileData, size_t size, bool skipGPUData);
 static bool _imd_load_level_textures(const iIMDShape& s, size_t tilesetIdx, iIMDShapeTextures& output);
 
 iIMDShape::~iIMDShape()
@@ -186,16 +200,14 @@ static std::unique_ptr<iIMDShape> tryLoadDisplayModelInternal(const WzString &pa
 {
 	if (PHYSFS_exists(path + filename))
 	{
-		char *pFileData = nullptr, *fileEnd;
+		char *pFileData = nullptr;
 		UDWORD size = 0;
 		if (!loadFile(WzString(path + filename).toUtf8().c_str(), &pFileData, &size))
 		{
 			debug(LOG_ERROR, "Failed to load model file: %s", WzString(path + filename).toUtf8().c_str());
 			return nullptr;
 		}
-		fileEnd = pFileData + size;
-		const char *pFileDataPt = pFileData;
-		auto result = iV_ProcessIMD(filename, (const char **)&pFileDataPt, fileEnd, skipGPUupload);
+		auto result = iV_ProcessIMDCached(filename, pFileData, size, skipGPUupload);
 		free(pFileData);
 		return result;
 	}
@@ -1314,6 +1326,48 @@ void finishTangentsGeneration()
    }
 }
 
+/// Upload the GPU buffers of a shape level
+static void _imd_upload_level_buffers(iIMDShape &s, const WzString &filename, const std::string &key, const IMDLevelBuffers &b)
+{
+	if (!b.tangents.empty())
+	{
+		if (!s.buffers[VBO_TANGENT])
+			s.buffers[VBO_TANGENT] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "tangent buffer");
+		s.buffers[VBO_TANGENT]->upload(b.tangents.size() * sizeof(gfx_api::gfxFloat), b.tangents.data());
+	}
+	if (!s.buffers[VBO_VERTEX])
+		s.buffers[VBO_VERTEX] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "vertex buffer");
+	if (b.vertices.empty())
+	{
+		debug(LOG_ERROR, "_imd_load_level: file corrupt? - no vertices?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
+	}
+	s.buffers[VBO_VERTEX]->upload(b.vertices.size() * sizeof(gfx_api::gfxFloat), b.vertices.data());
+
+	if (!s.buffers[VBO_NORMAL])
+		s.buffers[VBO_NORMAL] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "normals buffer");
+	if (b.normals.empty())
+	{
+		debug(LOG_ERROR, "_imd_load_level: file corrupt? - no normals?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
+	}
+	s.buffers[VBO_NORMAL]->upload(b.normals.size() * sizeof(gfx_api::gfxFloat), b.normals.data());
+
+	if (!s.buffers[VBO_INDEX])
+		s.buffers[VBO_INDEX] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::index_buffer, gfx_api::context::buffer_storage_hint::static_draw, "index buffer");
+	if (b.indices.empty())
+	{
+		debug(LOG_ERROR, "_imd_load_level: file corrupt? - no indices?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
+	}
+	s.buffers[VBO_INDEX]->upload(b.indices.size() * sizeof(uint16_t), b.indices.data());
+
+	if (!s.buffers[VBO_TEXCOORD])
+		s.buffers[VBO_TEXCOORD] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "tex coords buffer");
+	if (b.texcoords.empty())
+	{
+		debug(LOG_ERROR, "_imd_load_level: file corrupt? - no texcoords?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
+	}
+	s.buffers[VBO_TEXCOORD]->upload(b.texcoords.size() * sizeof(gfx_api::gfxFloat), b.texcoords.data());
+}
+
 /*!
  * Load shape levels recursively
  * \param ppFileData Pointer to the data (usually read from a file)
@@ -1324,7 +1378,7 @@ void finishTangentsGeneration()
  * \post s allocated
  */
 static_assert(PATH_MAX >= 255, "PATH_MAX is insufficient!");
-static std::unique_ptr<iIMDShape> _imd_load_level(const WzString &filename, const char **ppFileData, const char *FileDataEnd, int pieVersion, uint32_t level, const LevelSettings &globalLevelSettings, bool skipGPUData)
+static std::unique_ptr<iIMDShape> _imd_load_level(const WzString &filename, const char **ppFileData, const char *FileDataEnd, int pieVersion, uint32_t level, const LevelSettings &globalLevelSettings, bool skipGPUData, std::vector<IMDLevelBuffers> *cacheOut)
 {
 	const char *pFileData = *ppFileData;
 	char buffer[PATH_MAX] = {'\0'}; uint32_t value = 0;
@@ -1619,46 +1673,19 @@ static std::unique_ptr<iIMDShape> _imd_load_level(const WzString &filename, cons
 			for (size_t i = 0; i < indices.size(); i += 3)
 				calculateTangentsForTriangle(indices[i], indices[i+1], indices[i+2]);
 			finishTangentsGeneration();
-
-			if (!tangents.empty())
-			{
-				if (!s.buffers[VBO_TANGENT])
-					s.buffers[VBO_TANGENT] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "tangent buffer");
-				s.buffers[VBO_TANGENT]->upload(tangents.size() * sizeof(gfx_api::gfxFloat), tangents.data());
-			}
-		}
-
-		if (!s.buffers[VBO_VERTEX])
-			s.buffers[VBO_VERTEX] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "vertex buffer");
-		if (vertices.empty())
-		{
-			debug(LOG_ERROR, "_imd_load_level: file corrupt? - no vertices?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
 		}
-		s.buffers[VBO_VERTEX]->upload(vertices.size() * sizeof(gfx_api::gfxFloat), vertices.data());
 
-		if (!s.buffers[VBO_NORMAL])
-			s.buffers[VBO_NORMAL] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "normals buffer");
-		if (normals.empty())
+		IMDLevelBuffers levelBuffers;
+		levelBuffers.vertices.swap(vertices);
+		levelBuffers.normals.swap(normals);
+		levelBuffers.texcoords.swap(texcoords);
+		levelBuffers.tangents.swap(tangents);
+		levelBuffers.indices.swap(indices);
+		_imd_upload_level_buffers(s, filename, key, levelBuffers);
+		if (cacheOut != nullptr)
 		{
-			debug(LOG_ERROR, "_imd_load_level: file corrupt? - no normals?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
+			cacheOut->push_back(std::move(levelBuffers));
 		}
-		s.buffers[VBO_NORMAL]->upload(normals.size() * sizeof(gfx_api::gfxFloat), normals.data());
-
-		if (!s.buffers[VBO_INDEX])
-			s.buffers[VBO_INDEX] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::index_buffer, gfx_api::context::buffer_storage_hint::static_draw, "index buffer");
-		if (indices.empty())
-		{
-			debug(LOG_ERROR, "_imd_load_level: file corrupt? - no indices?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
-		}
-		s.buffers[VBO_INDEX]->upload(indices.size() * sizeof(uint16_t), indices.data());
-
-		if (!s.buffers[VBO_TEXCOORD])
-			s.buffers[VBO_TEXCOORD] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "tex coords buffer");
-		if (texcoords.empty())
-		{
-			debug(LOG_ERROR, "_imd_load_level: file corrupt? - no texcoords?: %s (key: %s)", filename.toUtf8().c_str(), key.c_str());
-		}
-		s.buffers[VBO_TEXCOORD]->upload(texcoords.size() * sizeof(gfx_api::gfxFloat), texcoords.data());
 	}
 
 	indices.resize(0);
@@ -1689,7 +1716,7 @@ static std::unique_ptr<iIMDShape> _imd_load_level(const WzString &filename, cons
  * \return The shape, constructed from the data read
  */
 // ppFileData is incremented to the end of the file on exit!
-static std::unique_ptr<iIMDShape> iV_ProcessIMD(const WzString &filename, const char **ppFileData, const char *FileDataEnd, bool skipGPUData)
+static std::unique_ptr<iIMDShape> iV_ProcessIMD(const WzString &filename, const char **ppFileData, const char *FileDataEnd, bool skipGPUData, std::vector<IMDLevelBuffers> *cacheOut)
 {
 	const char *pFileData = *ppFileData;
 	char buffer[PATH_MAX] = {};
@@ -1819,7 +1846,7 @@ static std::unique_ptr<iIMDShape> iV_ProcessIMD(const WzString &filename, const
 			return nullptr;
 		}
 
-		std::unique_ptr<iIMDShape> shape = _imd_load_level(filename, &lineToProcess.pNextLineBegin, FileDataEnd, imd_version, level, globalLevelSettings, skipGPUData);
+		std::unique_ptr<iIMDShape> shape = _imd_load_level(filename, &lineToProcess.pNextLineBegin, FileDataEnd, imd_version, level, globalLevelSettings, skipGPUData, cacheOut);
 		if (shape == nullptr)
 		{
 			debug(LOG_ERROR, "%s: Unsuccessful loading level %" PRIu32, filename.toUtf8().c_str(), (level + 1));
@@ -1855,3 +1882,384 @@ static std::unique_ptr<iIMDShape> iV_ProcessIMD(const WzString &filename, const
 	*ppFileData = pFileData;
 	return firstLevel;
 }
+
+/*
+ * Binary model cache
+ *
+ * Parsing a PIE file, welding its vertices and generating its tangents is a
+ * noticeable part of startup. The result of that work is written to
+ * IMD_CACHE_DIR in the write directory, one blob per model name, and read back
+ * on later runs instead of parsing the text again. Each blob records the
+ * IMD_CACHE_FORMAT_VERSION and the sha256 of the model file it was built from,
+ * and is only used if both still match. Otherwise it is overwritten by the
+ * next store, so stale blobs don't accumulate.
+ * Blobs are in native byte order, and are validated before use, since they are
+ * only as trustworthy as the write directory.
+ */
+
+#define IMD_CACHE_DIR		"cache/models"
+#define IMD_CACHE_MAGIC		0x434d5a57 // "WZMC" (little-endian)
+#define IMD_CACHE_FORMAT_VERSION	2	// Bump whenever the blob layout, or what the loader produces, changes
+
+static bool imdCacheWritable = true;
+
+class IMDCacheWriter
+{
+public:
+	template <typename T>
+	void pod(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be cached");
+		const uint8_t *pValue = reinterpret_cast<const uint8_t *>(&value);
+		data.insert(data.end(), pValue, pValue + sizeof(T));
+	}
+
+	template <typename T>
+	void vec(const std::vector<T> &values)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be cached");
+		pod(static_cast<uint32_t>(values.size()));
+		const uint8_t *pValues = reinterpret_cast<const uint8_t *>(values.data());
+		data.insert(data.end(), pValues, pValues + values.size() * sizeof(T));
+	}
+
+	void str(const std::string &value)
+	{
+		pod(static_cast<uint32_t>(value.size()));
+		data.insert(data.end(), value.begin(), value.end());
+	}
+
+	std::vector<uint8_t> data;
+};
+
+class IMDCacheReader
+{
+public:
+	IMDCacheReader(const char *pData, size_t size) : p(reinterpret_cast<const uint8_t *>(pData)), end(p + size) {}
+
+	template <typename T>
+	bool pod(T &value)
+	{
+		if (static_cast<size_t>(end - p) < sizeof(T))
+		{
+			return false;
+		}
+		memcpy(&value, p, sizeof(T));
+		p += sizeof(T);
+		return true;
+	}
+
+	template <typename T>
+	bool vec(std::vector<T> &values)
+	{
+		uint32_t count = 0;
+		if (!pod(count) || static_cast<size_t>(end - p) / sizeof(T) < count)
+		{
+			return false;
+		}
+		values.resize(count);
+		memcpy(values.data(), p, count * sizeof(T));
+		p += count * sizeof(T);
+		return true;
+	}
+
+	bool str(std::string &value)
+	{
+		uint32_t count = 0;
+		if (!pod(count) || static_cast<size_t>(end - p) < count)
+		{
+			return false;
+		}
+		value.assign(reinterpret_cast<const char *>(p), count);
+		p += count;
+		return true;
+	}
+
+	bool atEnd() const
+	{
+		return p == end;
+	}
+
+private:
+	const uint8_t *p;
+	const uint8_t *end;
+};
+
+static bool _imd_cache_polys_valid(const std::vector<iIMDPoly> &polys, size_t npoints)
+{
+	for (const iIMDPoly &poly : polys)
+	{
+		if (poly.texCoord.size() != 3)
+		{
+			return false;
+		}
+		for (uint32_t pindex : poly.pindex)
+		{
+			if (pindex >= npoints)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void _imd_cache_write_polys(IMDCacheWriter &w, const std::vector<iIMDPoly> &polys)
+{
+	w.pod(static_cast<uint32_t>(polys.size()));
+	for (const iIMDPoly &poly : polys)
+	{
+		w.vec(poly.texCoord);
+		w.pod(poly.texAnim);
+		w.pod(poly.flags);
+		w.pod(poly.zcentre);
+		w.pod(poly.normal);
+		w.pod(poly.pindex);
+	}
+}
+
+static bool _imd_cache_read_polys(IMDCacheReader &r, std::vector<iIMDPoly> &polys)
+{
+	uint32_t count = 0;
+	if (!r.pod(count) || count > (1u << 24))
+	{
+		return false;
+	}
+	polys.resize(count);
+	for (iIMDPoly &poly : polys)
+	{
+		if (!r.vec(poly.texCoord) || !r.pod(poly.texAnim) || !r.pod(poly.flags) || !r.pod(poly.zcentre) || !r.pod(poly.normal) || !r.pod(poly.pindex))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _imd_cache_write_level(IMDCacheWriter &w, const iIMDShape &s, const IMDLevelBuffers &b)
+{
+	w.pod(s.min);
+	w.pod(s.max);
+	w.pod(s.sradius);
+	w.pod(s.radius);
+	w.pod(s.ocen);
+	w.vec(s.connectors);
+	w.pod(s.flags);
+	w.pod(s.numFrames);
+	w.pod(s.animInterval);
+	w.vec(s.points);
+	_imd_cache_write_polys(w, s.polys);
+	w.vec(s.altShadowPoints);
+	_imd_cache_write_polys(w, s.altShadowPolys);
+	w.pod(static_cast<uint8_t>(s.pShadowPoints == &s.altShadowPoints));
+	w.pod(s.vertexCount);
+	w.vec(b.vertices);
+	w.vec(b.normals);
+	w.vec(b.texcoords);
+	w.vec(b.tangents);
+	w.vec(b.indices);
+	w.vec(s.objanimdata);
+	w.pod(s.objanimframes);
+	w.pod(s.objanimtime);
+	w.pod(s.objanimcycles);
+	w.pod(s.interpolate);
+	for (const TilesetTextureFiles &files : s.tilesetTextureFiles)
+	{
+		w.str(files.texfile);
+		w.str(files.tcmaskfile);
+		w.str(files.normalfile);
+		w.str(files.specfile);
+	}
+}
+
+static bool _imd_cache_read_level(IMDCacheReader &r, iIMDShape &s, IMDLevelBuffers &b)
+{
+	uint8_t altShadows = 0;
+	bool ok = r.pod(s.min) && r.pod(s.max) && r.pod(s.sradius) && r.pod(s.radius) && r.pod(s.ocen)
+	          && r.vec(s.connectors) && r.pod(s.flags) && r.pod(s.numFrames) && r.pod(s.animInterval)
+	          && r.vec(s.points) && _imd_cache_read_polys(r, s.polys)
+	          && r.vec(s.altShadowPoints) && _imd_cache_read_polys(r, s.altShadowPolys) && r.pod(altShadows)
+	          && r.pod(s.vertexCount)
+	          && r.vec(b.vertices) && r.vec(b.normals) && r.vec(b.texcoords) && r.vec(b.tangents) && r.vec(b.indices)
+	          && r.vec(s.objanimdata) && r.pod(s.objanimframes) && r.pod(s.objanimtime) && r.pod(s.objanimcycles) && r.pod(s.interpolate);
+	for (TilesetTextureFiles &files : s.tilesetTextureFiles)
+	{
+		ok = ok && r.str(files.texfile) && r.str(files.tcmaskfile) && r.str(files.normalfile) && r.str(files.specfile);
+	}
+	if (!ok)
+	{
+		return false;
+	}
+
+	// Everything that is used to index something else must be in range
+	const size_t vertexCount = s.vertexCount;
+	if (!_imd_cache_polys_valid(s.polys, s.points.size()) || !_imd_cache_polys_valid(s.altShadowPolys, s.altShadowPoints.size())
+	    || b.vertices.size() != vertexCount * 3 || b.normals.size() != vertexCount * 3 || b.texcoords.size() != vertexCount * 4
+	    || (!b.tangents.empty() && b.tangents.size() != vertexCount * 4) || b.indices.size() % 3 != 0
+	    || std::any_of(b.indices.begin(), b.indices.end(), [vertexCount](uint16_t index) { return index >= vertexCount; }))
+	{
+		return false;
+	}
+	s.pShadowPoints = altShadows ? &s.altShadowPoints : &s.points;
+	s.pShadowPolys = altShadows ? &s.altShadowPolys : &s.polys;
+	return true;
+}
+
+static std::string _imd_cache_file(const WzString &filename)
+{
+	const std::string name = filename.toStdString();
+	return std::string(IMD_CACHE_DIR "/") + sha256Sum(name.data(), name.size()).toString() + ".bin";
+}
+
+static std::unique_ptr<iIMDShape> _imd_cache_load(const WzString &filename, const std::string &cacheFile, const Sha256 &sourceHash, bool skipGPUData)
+{
+	if (!PHYSFS_exists(cacheFile.c_str()))
+	{
+		return nullptr;
+	}
+	// Don't pick up cache files from the rest of the search path (e.g. shipped in a mod or map archive)
+	const char *writeDir = PHYSFS_getWriteDir();
+	if (writeDir == nullptr || WZ_PHYSFS_getRealDir_String(cacheFile.c_str()) != writeDir)
+	{
+		debug(LOG_WARNING, "%s: Ignoring model cache file %s outside the write directory", filename.toUtf8().c_str(), cacheFile.c_str());
+		return nullptr;
+	}
+	char *pCacheData = nullptr;
+	UDWORD cacheSize = 0;
+	if (!loadFile(cacheFile.c_str(), &pCacheData, &cacheSize, false))
+	{
+		return nullptr;
+	}
+
+	IMDCacheReader r(pCacheData, cacheSize);
+	uint32_t magic = 0, version = 0, nlevels = 0;
+	Sha256 blobSourceHash;
+	if (!r.pod(magic) || magic != IMD_CACHE_MAGIC || !r.pod(version) || version != IMD_CACHE_FORMAT_VERSION
+	    || !r.pod(blobSourceHash) || blobSourceHash != sourceHash)
+	{
+		// Built by another loader version, or from an older version of the model file
+		free(pCacheData);
+		return nullptr;
+	}
+	std::array<std::string, ANIM_EVENT_COUNT> animNames;
+	bool ok = r.pod(nlevels) && nlevels > 0;
+	for (std::string &animName : animNames)
+	{
+		ok = ok && r.str(animName);
+	}
+
+	std::unique_ptr<iIMDShape> firstLevel = nullptr;
+	iIMDShape *lastLevel = nullptr;
+	for (uint32_t level = 0; ok && level < nlevels; ++level)
+	{
+		std::string key = filename.toStdString();
+		if (level > 0)
+		{
+			key += "_" + std::to_string(level);
+		}
+		auto shape = std::make_unique<iIMDShape>();
+		shape->modelName = WzString::fromUtf8(key);
+		shape->modelLevel = level;
+		IMDLevelBuffers levelBuffers;
+		ok = _imd_cache_read_level(r, *shape, levelBuffers);
+		if (ok && !skipGPUData)
+		{
+			_imd_upload_level_buffers(*shape, filename, key, levelBuffers);
+		}
+
+		iIMDShape *pShape = shape.get();
+		if (lastLevel)
+		{
+			lastLevel->next = std::move(shape);
+		}
+		else
+		{
+			firstLevel = std::move(shape);
+		}
+		lastLevel = pShape;
+	}
+	ok = ok && r.atEnd();
+	free(pCacheData);
+
+	if (!ok)
+	{
+		debug(LOG_WARNING, "%s: Ignoring bad model cache file %s", filename.toUtf8().c_str(), cacheFile.c_str());
+		return nullptr;
+	}
+
+	for (int i = 0; i < ANIM_EVENT_COUNT; i++)
+	{
+		firstLevel->objanimpie[i] = animNames[i].empty() ? nullptr : modelGet(WzString::fromUtf8(animNames[i]));
+	}
+	return firstLevel;
+}
+
+static void _imd_cache_store(const std::string &cacheFile, const Sha256 &sourceHash, const iIMDShape &firstLevel, const std::vector<IMDLevelBuffers> &levelBuffers)
+{
+	uint32_t nlevels = 0;
+	for (const iIMDShape *pShape = &firstLevel; pShape != nullptr; pShape = pShape->next.get())
+	{
+		++nlevels;
+	}
+	ASSERT_OR_RETURN(, nlevels == levelBuffers.size(), "Level count mismatch: %" PRIu32 " != %zu", nlevels, levelBuffers.size());
+
+	IMDCacheWriter w;
+	w.pod(static_cast<uint32_t>(IMD_CACHE_MAGIC));
+	w.pod(static_cast<uint32_t>(IMD_CACHE_FORMAT_VERSION));
+	w.pod(sourceHash);
+	w.pod(nlevels);
+	for (int i = 0; i < ANIM_EVENT_COUNT; i++)
+	{
+		iIMDShape *pAnim = safeGetDisplayModelFromBase(firstLevel.objanimpie[i]);
+		w.str(pAnim ? pAnim->modelName.toStdString() : std::string());
+	}
+	size_t level = 0;
+	for (const iIMDShape *pShape = &firstLevel; pShape != nullptr; pShape = pShape->next.get())
+	{
+		_imd_cache_write_level(w, *pShape, levelBuffers[level++]);
+	}
+
+	PHYSFS_mkdir(IMD_CACHE_DIR);
+	PHYSFS_file *fileHandle = PHYSFS_openWrite(cacheFile.c_str());
+	if (fileHandle == nullptr)
+	{
+		debug(LOG_WARNING, "Could not write model cache file %s: %s - not caching models", cacheFile.c_str(), WZ_PHYSFS_getLastError());
+		imdCacheWritable = false;
+		return;
+	}
+	bool written = WZ_PHYSFS_writeBytes(fileHandle, w.data.data(), static_cast<PHYSFS_uint32>(w.data.size())) == static_cast<PHYSFS_sint64>(w.data.size());
+	written = PHYSFS_close(fileHandle) != 0 && written;
+	if (!written)
+	{
+		debug(LOG_WARNING, "Could not write model cache file %s: %s", cacheFile.c_str(), WZ_PHYSFS_getLastError());
+		PHYSFS_delete(cacheFile.c_str());
+	}
+}
+
+/*!
+ * Load a model file, from the model cache if it holds an entry for the file's contents
+ * \param pFileData Data from the IMD file
+ * \param size Size of the data
+ * \return The shape, constructed from the cache or from the data
+ */
+static std::unique_ptr<iIMDShape> iV_ProcessIMDCached(const WzString &filename, const char *pFileData, size_t size, bool skipGPUData)
+{
+	const std::string cacheFile = _imd_cache_file(filename);
+	const Sha256 sourceHash = sha256Sum(pFileData, size);
+	auto result = _imd_cache_load(filename, cacheFile, sourceHash, skipGPUData);
+	if (result)
+	{
+		return result;
+	}
+
+	// the GPU data is only built when it is uploaded, so only cache models loaded with it
+	std::vector<IMDLevelBuffers> levelBuffers;
+	const bool store = imdCacheWritable && !skipGPUData;
+	const char *pFileDataPt = pFileData;
+	result = iV_ProcessIMD(filename, &pFileDataPt, pFileData + size, skipGPUData, store ? &levelBuffers : nullptr);
+	if (result && store)
+	{
+		_imd_cache_store(cacheFile, sourceHash, *result, levelBuffers);
+	}
+	return result;
+}
@@ -56,6 +56,28 @@
 static GFX *radarGfx[NUM_RADAR_TEXTURES] = {nullptr};
 static size_t currRadarGfx = 0;
 
+/// Part of a radar texture that is older than the last downloaded radar bitmap, as [x0, x1) x [y0, y1).
+struct RadarStaleRect
+{
+	size_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+	bool empty() const { return x0 >= x1 || y0 >= y1; }
+	void add(size_t ax0, size_t ay0, size_t ax1, size_t ay1)
+	{
+		if (empty())
+		{
+			*this = {ax0, ay0, ax1, ay1};
+			return;
+		}
+		x0 = std::min(x0, ax0);
+		y0 = std::min(y0, ay0);
+		x1 = std::max(x1, ax1);
+		y1 = std::max(y1, ay1);
+	}
+};
+static RadarStaleRect radarStale[NUM_RADAR_TEXTURES];
+static iV_Image radarSubImage;
+
 /***************************************************************************/
 /*
  *	Static function forward declarations
@@ -130,6 +152,13 @@ void GFX::updateTexture(const iV_Image& image /*= nullptr*/)
 	mTexture->upload(0u, image);
 }
 
+void GFX::updateTextureRegion(size_t x, size_t y, const iV_Image& image)
+{
+	ASSERT(mType == GFX_TEXTURE, "Wrong GFX type");
+	ASSERT_OR_RETURN(, mTexture != nullptr, "Null texture??");
+	mTexture->upload_sub(0u, x, y, image);
+}
+
 void GFX::buffers(int vertices, const void *vertBuf, const void *auxBuf)
 {
 	if (!mBuffers[VBO_VERTEX])
@@ -585,18 +614,31 @@ void iV_DrawImageText(gfx_api::texture& TextureID, Vector2f Position, Vector2f o
 	iv_DrawImageImpl<gfx_api::DrawImageTextPSO>(TextureID, offset, size, Vector2f(0.f, 0.f), Vector2f(1.f, 1.f), colour, mvp, SHADER_TEXT);
 }
 
-void iV_DrawImageTextClipped(gfx_api::texture& TextureID, Vector2i textureSize, Vector2f Position, Vector2f offset, Vector2f size, float angle, PIELIGHT colour, WzRect clippingRect)
+void iV_DrawImageTextRegion(gfx_api::texture& TextureID, Vector2f Position, Vector2f offset, Vector2f size, Vector2f uvOffset, Vector2f uvSize, float angle, PIELIGHT colour)
 {
 	glm::mat4 mvp = defaultProjectionMatrix() * glm::translate(glm::vec3(Position.x, Position.y, 0)) * glm::rotate(RADIANS(angle), glm::vec3(0.f, 0.f, 1.f));
 
-	gfx_api::gfxFloat invTextureSizeX = 1.f / textureSize.x;
-	gfx_api::gfxFloat invTextureSizeY = 1.f / textureSize.y;
-	float tu = (float)(clippingRect.x()) * invTextureSizeX;
-	float tv = (float)(clippingRect.y()) * invTextureSizeY;
-	float su = (float)(clippingRect.x() + clippingRect.width()) * invTextureSizeX;
-	float sv = (float)(clippingRect.y() + clippingRect.height()) * invTextureSizeY;
+	iv_DrawImageImpl<gfx_api::DrawImageTextPSO>(TextureID, offset, size, uvOffset, uvSize, colour, mvp, SHADER_TEXT);
+}
+
+void iV_DrawImageTextInstanced(gfx_api::texture& TextureID, gfx_api::buffer& instanceBuffer, size_t instanceBufferOffset, size_t instanceCount, Vector2f Position, Vector2f scale, float angle, PIELIGHT colour)
+{
+	if (instanceCount == 0)
+	{
+		return;
+	}
+
+	glm::mat4 mvp = defaultProjectionMatrix() * glm::translate(glm::vec3(Position.x, Position.y, 0)) * glm::rotate(RADIANS(angle), glm::vec3(0.f, 0.f, 1.f)) * glm::scale(glm::vec3(scale.x, scale.y, 1.f));
 
-	iv_DrawImageImpl<gfx_api::DrawImageTextPSO>(TextureID, offset, size, Vector2f(tu, tv), Vector2f(su, sv), colour, mvp, SHADER_TEXT);
+	gfx_api::DrawImageTextPSO_Instanced::get().bind();
+	gfx_api::DrawImageTextPSO_Instanced::get().bind_constants({ mvp,
+		glm::vec4(colour.vector[0] / 255.f, colour.vector[1] / 255.f, colour.vector[2] / 255.f, colour.vector[3] / 255.f) });
+	gfx_api::DrawImageTextPSO_Instanced::get().bind_textures(&TextureID);
+	gfx_api::context::get().bind_vertex_buffers(0, {
+		std::make_tuple(pie_internal::rectBuffer, 0),
+		std::make_tuple(&instanceBuffer, instanceBufferOffset)});
+	gfx_api::DrawImageTextPSO_Instanced::get().draw_instanced(4, 0, instanceCount);
+	gfx_api::DrawImageTextPSO_Instanced::get().unbind_vertex_buffers(pie_internal::rectBuffer, &instanceBuffer);
 }
 
 template<typename PSO>
@@ -927,6 +969,7 @@ bool pie_ShutdownRadar()
 		radarGfx[i] = nullptr;
 	}
 	currRadarGfx = 0;
+	radarSubImage.clear();
 	pie_ViewingWindow_Shutdown();
 	return true;
 }
@@ -944,18 +987,53 @@ void pie_SetRadar(gfx_api::gfxFloat x, gfx_api::gfxFloat y, gfx_api::gfxFloat wi
 		gfx_api::gfxFloat texcoords[] = { 0.0f, 0.0f,  1.0f, 0.0f,  0.0f, 1.0f,  1.0f, 1.0f };
 		gfx_api::gfxFloat vertices[] = { x, y,  x + width, y,  x, y + height,  x + width, y + height };
 		radarGfx[i]->buffers(4, vertices, texcoords);
+		radarStale[i] = RadarStaleRect();
+		radarStale[i].add(0, 0, twidth, theight);
 	}
 }
 
 /** Store radar texture with given width and height. */
 void pie_DownLoadRadar(const iV_Image& bitmap)
 {
+	pie_DownLoadRadar(bitmap, 0, 0, bitmap.width(), bitmap.height());
+}
+
+/** Store the radar texture, where only [x0, x1) x [y0, y1) changed since the last call.
+ *  Each texture in the ring remembers what it missed, so only that part gets uploaded when it comes round again. */
+void pie_DownLoadRadar(const iV_Image& bitmap, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+	x1 = std::min<size_t>(x1, bitmap.width());
+	y1 = std::min<size_t>(y1, bitmap.height());
+	if (x0 >= x1 || y0 >= y1)
+	{
+		return;  // Nothing changed, keep showing the current texture.
+	}
+	for (size_t i = 0; i < NUM_RADAR_TEXTURES; ++i)
+	{
+		radarStale[i].add(x0, y0, x1, y1);
+	}
 	currRadarGfx++;
 	if (currRadarGfx >= NUM_RADAR_TEXTURES)
 	{
 		currRadarGfx = 0;
 	}
-	radarGfx[currRadarGfx]->updateTexture(bitmap);
+	RadarStaleRect &stale = radarStale[currRadarGfx];
+	if (stale.x0 == 0 && stale.y0 == 0 && stale.x1 >= bitmap.width() && stale.y1 >= bitmap.height())
+	{
+		radarGfx[currRadarGfx]->updateTexture(bitmap);
+	}
+	else
+	{
+		const size_t channels = bitmap.channels();
+		const size_t rowBytes = (stale.x1 - stale.x0) * channels;
+		radarSubImage.allocate(static_cast<unsigned>(stale.x1 - stale.x0), static_cast<unsigned>(stale.y1 - stale.y0), static_cast<unsigned>(channels));
+		for (size_t y = stale.y0; y < stale.y1; ++y)
+		{
+			memcpy(radarSubImage.bmp_w() + (y - stale.y0) * rowBytes, bitmap.bmp() + (y * bitmap.width() + stale.x0) * channels, rowBytes);
+		}
+		radarGfx[currRadarGfx]->updateTextureRegion(stale.x0, stale.y0, radarSubImage);
+	}
+	stale = RadarStaleRect();
 }
 
 /** Display radar texture using the given height and width, depending on zoom level. */
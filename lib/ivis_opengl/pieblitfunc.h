@@ -97,6 +97,9 @@ public:
 	/// Upload given memory buffer to already allocated texture space on the GPU
 	void updateTexture(const iV_Image& image /*= nullptr*/);
 
+	/// Upload given memory buffer to the part of the already allocated texture starting at x, y
+	void updateTextureRegion(size_t x, size_t y, const iV_Image& image);
+
 	/// Upload vertex and texture buffer data to the GPU
 	void buffers(int vertices, const void *vertBuf, const void *texBuf);
 
@@ -274,7 +277,10 @@ private:
 
 void iV_DrawImageAnisotropic(gfx_api::texture& TextureID, Vector2i Position, Vector2f offset, Vector2f size, float angle, PIELIGHT colour);
 void iV_DrawImageText(gfx_api::texture& TextureID, Vector2f Position, Vector2f offset, Vector2f size, float angle, PIELIGHT colour);
-void iV_DrawImageTextClipped(gfx_api::texture& TextureID, Vector2i textureSize, Vector2f Position, Vector2f offset, Vector2f size, float angle, PIELIGHT colour, WzRect clippingRect);
+// Draws a sub-region (uvOffset / uvSize, in normalized texture coordinates) of a text texture
+void iV_DrawImageTextRegion(gfx_api::texture& TextureID, Vector2f Position, Vector2f offset, Vector2f size, Vector2f uvOffset, Vector2f uvSize, float angle, PIELIGHT colour);
+// Draws instanceCount glyph quads (gfx_api::TextGlyphPerInstanceInterleavedData) from instanceBuffer, in a single draw call
+void iV_DrawImageTextInstanced(gfx_api::texture& TextureID, gfx_api::buffer& instanceBuffer, size_t instanceBufferOffset, size_t instanceCount, Vector2f Position, Vector2f scale, float angle, PIELIGHT colour);
 void iV_DrawImage(IMAGEFILE *ImageFile, UWORD ID, int x, int y, const glm::mat4 &modelViewProjection = defaultProjectionMatrix(), BatchedImageDrawRequests* pBatchedRequests = nullptr, uint8_t alpha = 255);
 void iV_DrawImageTint(IMAGEFILE *ImageFile, UWORD ID, float x, float y, PIELIGHT color, optional<Vector2f> size = nullopt, const glm::mat4 &modelViewProjection = defaultProjectionMatrix(), BatchedImageDrawRequests* pBatchedRequests = nullptr);
 void iV_DrawImageFileAnisotropic(IMAGEFILE *ImageFile, UWORD ID, int x, int y, Vector2f size, const glm::mat4 &modelViewProjection = defaultProjectionMatrix(), uint8_t alpha = 255);
@@ -302,6 +308,7 @@ bool assertValidImage(IMAGEFILE *imageFile, unsigned id);
 bool pie_InitRadar();
 bool pie_ShutdownRadar();
 void pie_DownLoadRadar(const iV_Image& bitmap);
+void pie_DownLoadRadar(const iV_Image& bitmap, size_t x0, size_t y0, size_t x1, size_t y1);
 void pie_RenderRadar(const glm::mat4 &modelViewProjectionMatrix);
 void pie_SetRadar(gfx_api::gfxFloat x, gfx_api::gfxFloat y, gfx_api::gfxFloat width, gfx_api::gfxFloat height, size_t twidth, size_t theight);
 
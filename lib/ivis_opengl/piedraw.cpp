@@ -43,6 +43,7 @@
 #include <vector>
 #include <algorithm>
 #include <unordered_set>
+#include <tuple>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -59,6 +60,9 @@
 
 #define BUFFER_OFFSET(i) (reinterpret_cast<char *>(i))
 #define SHADOW_END_DISTANCE (8000*8000) // Keep in sync with lighting.c:FOG_END
+#define INSTANCE_BATCH_MIN_SLOTS 4
+#define INSTANCE_BATCH_EVICT_AFTER 600 // frames a mesh batch may go unused before its instance slots are given up
+#define INSTANCE_UPLOAD_MERGE_GAP 8 // unchanged instance slots re-sent to join two changed ranges into one update
 
 /*
  *	Local Variables
@@ -996,9 +1000,36 @@ private:
 	bool useInstancedRendering = false;
 
 	typedef templatedState MeshInstanceKey;
-	std::unordered_map<MeshInstanceKey, std::vector<SHAPE>> instanceMeshes;
-	std::unordered_map<MeshInstanceKey, std::vector<SHAPE>> instanceTranslucentMeshes;
-	std::unordered_map<MeshInstanceKey, std::vector<SHAPE>> instanceAdditiveMeshes;
+
+	enum class InstanceCategory
+	{
+		Opaque,
+		Translucent,
+		Additive
+	};
+
+	// All instances of one mesh + state, drawn with a single instanced draw call.
+	// Each batch owns a fixed range of slots in the instance buffer, which persists across frames - a slot is only
+	// regenerated (and re-uploaded) when the instance queued into it differs from the one it held last frame.
+	struct InstanceBatch
+	{
+		MeshInstanceKey state;
+		InstanceCategory category = InstanceCategory::Opaque;
+		std::vector<SHAPE> queued;		// instances queued this frame
+		std::vector<SHAPE> slotShapes;	// the instance each slot currently holds
+		size_t firstSlot = 0;
+		size_t slotCapacity = 0;
+		uint64_t lastUsedSerial = 0;
+	};
+
+	void queueInstance(const MeshInstanceKey& state, InstanceCategory category, const SHAPE& shape);
+	void layoutInstanceBatches();
+	void uploadInstanceData();
+
+	std::vector<InstanceBatch> instanceBatches;
+	std::unordered_map<MeshInstanceKey, size_t> instanceBatchIndices;
+	std::vector<size_t> sortedInstanceBatches; // sorted by category, then state
+	bool instanceBatchLayoutDirty = false;
 	size_t instancesCount = 0;
 	size_t translucentInstancesCount = 0;
 	size_t additiveInstancesCount = 0;
@@ -1006,8 +1037,15 @@ private:
 	std::vector<SHAPE> tshapes;
 	std::vector<SHAPE> shapes;
 
+	// CPU-side copy of the instance buffer contents, and the FinalizeInstances() serial at which each slot last changed
 	std::vector<gfx_api::Draw3DShapePerInstanceInterleavedData> instancesData;
+	std::vector<uint64_t> instanceSlotChangedSerial;
+	uint64_t finalizeSerial = 0;
+	uint64_t layoutSerial = 0;
+	uint64_t lastChangeSerial = 0;
+
 	std::vector<gfx_api::buffer*> instanceDataBuffers;
+	std::vector<uint64_t> instanceDataBufferSerials; // the serial each buffer was last brought up-to-date with (0 = never)
 	size_t currInstanceBufferIdx = 0;
 
 	gfx_api::texture* lightmapTexture = nullptr;
@@ -1044,17 +1082,19 @@ bool InstancedMeshRenderer::initialize()
 	instanceDataBuffers.resize(gfx_api::context::get().maxFramesInFlight() + 1);
 	for (size_t i = 0; i < instanceDataBuffers.size(); ++i)
 	{
-		instanceDataBuffers[i] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::stream_draw, "InstancedMeshRenderer::instanceDataBuffer[" + std::to_string(i) + "]");
+		instanceDataBuffers[i] = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::dynamic_draw, "InstancedMeshRenderer::instanceDataBuffer[" + std::to_string(i) + "]");
 	}
+	instanceDataBufferSerials.assign(instanceDataBuffers.size(), 0);
 	useInstancedRendering = true;
 	return true;
 }
 
 void InstancedMeshRenderer::clear()
 {
-	instanceMeshes.clear();
-	instanceTranslucentMeshes.clear();
-	instanceAdditiveMeshes.clear();
+	for (auto& batch : instanceBatches)
+	{
+		batch.queued.clear();
+	}
 	instancesCount = 0;
 	translucentInstancesCount = 0;
 	additiveInstancesCount = 0;
@@ -1072,6 +1112,33 @@ void InstancedMeshRenderer::reset()
 		delete buffer;
 	}
 	instanceDataBuffers.clear();
+	instanceDataBufferSerials.clear();
+	currInstanceBufferIdx = 0;
+
+	instanceBatches.clear();
+	instanceBatchIndices.clear();
+	sortedInstanceBatches.clear();
+	instanceBatchLayoutDirty = false;
+	instancesData.clear();
+	instanceSlotChangedSerial.clear();
+	finalizedDrawCalls.clear();
+	finalizeSerial = 0;
+	layoutSerial = 0;
+	lastChangeSerial = 0;
+}
+
+void InstancedMeshRenderer::queueInstance(const MeshInstanceKey& state, InstanceCategory category, const SHAPE& shape)
+{
+	auto it = instanceBatchIndices.find(state);
+	if (it == instanceBatchIndices.end())
+	{
+		it = instanceBatchIndices.emplace(state, instanceBatches.size()).first;
+		instanceBatches.emplace_back();
+		instanceBatches.back().state = state;
+		instanceBatches.back().category = category;
+		instanceBatchLayoutDirty = true;
+	}
+	instanceBatches[it->second].queued.push_back(shape);
 }
 
 bool InstancedMeshRenderer::Draw3DShape(iIMDShape *shape, int frame, PIELIGHT teamcolour, PIELIGHT colour, int pieFlag, int pieFlagData, const glm::mat4 &modelMatrix, const glm::mat4 &viewMatrix, float stretchDepth)
@@ -1128,7 +1195,7 @@ bool InstancedMeshRenderer::Draw3DShape(iIMDShape *shape, int frame, PIELIGHT te
 	{
 		if (useInstancedRendering)
 		{
-			instanceAdditiveMeshes[currentState].push_back(tshape);
+			queueInstance(currentState, InstanceCategory::Additive, tshape);
 		}
 		else
 		{
@@ -1140,7 +1207,7 @@ bool InstancedMeshRenderer::Draw3DShape(iIMDShape *shape, int frame, PIELIGHT te
 	{
 		if (useInstancedRendering)
 		{
-			instanceTranslucentMeshes[currentState].push_back(tshape);
+			queueInstance(currentState, InstanceCategory::Translucent, tshape);
 		}
 		else
 		{
@@ -1178,7 +1245,7 @@ bool InstancedMeshRenderer::Draw3DShape(iIMDShape *shape, int frame, PIELIGHT te
 		}
 		if (useInstancedRendering)
 		{
-			instanceMeshes[currentState].push_back(tshape);
+			queueInstance(currentState, InstanceCategory::Opaque, tshape);
 		}
 		else
 		{
@@ -1349,70 +1416,189 @@ void pie_DrawAllMeshes(uint64_t currentGameFrame, const glm::mat4 &projectionMat
 	instancedMeshRenderer.DrawAll(currentGameFrame, projectionMatrix, viewMatrix, shadowMVPMatrix, drawParts, depthPass);
 }
 
-bool InstancedMeshRenderer::FinalizeInstances()
+static inline bool sameMeshInstance(const SHAPE& a, const SHAPE& b)
 {
-	if (!useInstancedRendering)
+	return (a.modelMatrix == b.modelMatrix)
+		&& (a.frame == b.frame)
+		&& (a.colour.rgba == b.colour.rgba)
+		&& (a.teamcolour.rgba == b.teamcolour.rgba)
+		&& (a.flag == b.flag)
+		&& (a.flag_data == b.flag_data)
+		&& (a.stretch == b.stretch);
+}
+
+static inline size_t instanceBatchSlotCapacity(size_t instanceCount)
+{
+	// leave headroom, so a batch growing by a few instances doesn't force every other batch to move
+	size_t capacity = INSTANCE_BATCH_MIN_SLOTS;
+	while (capacity < instanceCount + instanceCount / 2)
 	{
-		// nothing to do - without instanced rendering we just issue *tons* of draw calls...
-		return true;
+		capacity *= 2;
 	}
+	return capacity;
+}
 
-	instancesData.clear();
-	finalizedDrawCalls.clear();
+// Assigns each batch its range of slots in the instance buffer, dropping batches that haven't been used for a while.
+// Invalidates all slots (so everything is regenerated and uploaded) - only called when a batch is added or outgrows its range.
+void InstancedMeshRenderer::layoutInstanceBatches()
+{
+	instanceBatches.erase(std::remove_if(instanceBatches.begin(), instanceBatches.end(), [this](const InstanceBatch& batch) {
+		return batch.queued.empty() && (batch.lastUsedSerial + INSTANCE_BATCH_EVICT_AFTER < finalizeSerial);
+	}), instanceBatches.end());
+
+	instanceBatchIndices.clear();
+	sortedInstanceBatches.resize(instanceBatches.size());
+	for (size_t i = 0; i < instanceBatches.size(); ++i)
+	{
+		instanceBatchIndices[instanceBatches[i].state] = i;
+		sortedInstanceBatches[i] = i;
+	}
+	std::sort(sortedInstanceBatches.begin(), sortedInstanceBatches.end(), [this](size_t a, size_t b) {
+		const InstanceBatch& batchA = instanceBatches[a];
+		const InstanceBatch& batchB = instanceBatches[b];
+		return std::tie(batchA.category, batchA.state.shader, batchA.state.shape, batchA.state.pieFlag)
+			< std::tie(batchB.category, batchB.state.shader, batchB.state.shape, batchB.state.pieFlag);
+	});
 
-	if (instancesCount + translucentInstancesCount + additiveInstancesCount == 0)
+	size_t totalSlots = 0;
+	for (size_t idx : sortedInstanceBatches)
 	{
-		return true;
+		InstanceBatch& batch = instanceBatches[idx];
+		batch.firstSlot = totalSlots;
+		batch.slotCapacity = instanceBatchSlotCapacity(batch.queued.size());
+		batch.slotShapes.clear();
+		totalSlots += batch.slotCapacity;
 	}
+	instancesData.assign(totalSlots, gfx_api::Draw3DShapePerInstanceInterleavedData());
+	instanceSlotChangedSerial.assign(totalSlots, finalizeSerial);
 
-	instancesData.reserve(instancesCount + translucentInstancesCount + additiveInstancesCount);
+	layoutSerial = finalizeSerial;
+	lastChangeSerial = finalizeSerial;
+	instanceBatchLayoutDirty = false;
+}
 
-	for (const auto& mesh : instanceMeshes)
+// Brings an instance buffer up-to-date with instancesData, sending only the slots that changed since that buffer was last written
+void InstancedMeshRenderer::uploadInstanceData()
+{
+	if (instanceDataBufferSerials[currInstanceBufferIdx] != 0 && instanceDataBufferSerials[currInstanceBufferIdx] >= lastChangeSerial)
 	{
-		const auto& meshInstances = mesh.second;
-		size_t startingIdxInInstancesBuffer = instancesData.size();
-		for (const auto& instance : meshInstances)
-		{
-			instancesData.push_back(GenerateInstanceData(instance.frame, instance.colour, instance.teamcolour, instance.flag, instance.flag_data, instance.modelMatrix, instance.stretch));
-		}
-		finalizedDrawCalls.emplace_back(mesh.first, meshInstances.size(), startingIdxInInstancesBuffer);
+		// nothing changed - keep drawing from the current buffer
+		return;
 	}
 
-	startIdxTranslucentDrawCalls = finalizedDrawCalls.size();
+	++currInstanceBufferIdx;
+	if (currInstanceBufferIdx >= instanceDataBuffers.size())
+	{
+		currInstanceBufferIdx = 0;
+	}
+	gfx_api::buffer* buffer = instanceDataBuffers[currInstanceBufferIdx];
+	const uint64_t writtenSerial = instanceDataBufferSerials[currInstanceBufferIdx];
+	instanceDataBufferSerials[currInstanceBufferIdx] = finalizeSerial;
 
-	for (const auto& mesh : instanceTranslucentMeshes)
+	constexpr size_t stride = sizeof(gfx_api::Draw3DShapePerInstanceInterleavedData);
+	const size_t slotCount = instancesData.size();
+	if (writtenSerial == 0 || writtenSerial < layoutSerial || buffer->current_buffer_size() != slotCount * stride)
 	{
-		const auto& meshInstances = mesh.second;
-		size_t startingIdxInInstancesBuffer = instancesData.size();
-		for (const auto& instance : meshInstances)
+		buffer->upload(slotCount * stride, instancesData.data());
+		return;
+	}
+
+	size_t slot = 0;
+	while (slot < slotCount)
+	{
+		if (instanceSlotChangedSerial[slot] <= writtenSerial)
+		{
+			++slot;
+			continue;
+		}
+		// merge across short runs of unchanged slots, to keep the number of separate updates down
+		size_t rangeEnd = slot + 1;
+		for (size_t next = rangeEnd; next < slotCount && next - rangeEnd <= INSTANCE_UPLOAD_MERGE_GAP; ++next)
 		{
-			instancesData.push_back(GenerateInstanceData(instance.frame, instance.colour, instance.teamcolour, instance.flag, instance.flag_data, instance.modelMatrix, instance.stretch));
+			if (instanceSlotChangedSerial[next] > writtenSerial)
+			{
+				rangeEnd = next + 1;
+			}
 		}
-		finalizedDrawCalls.emplace_back(mesh.first, meshInstances.size(), startingIdxInInstancesBuffer);
+		buffer->update(slot * stride, (rangeEnd - slot) * stride, &instancesData[slot], gfx_api::buffer::update_flag::non_overlapping_updates_promise);
+		slot = rangeEnd;
+	}
+}
+
+bool InstancedMeshRenderer::FinalizeInstances()
+{
+	if (!useInstancedRendering)
+	{
+		// nothing to do - without instanced rendering we just issue *tons* of draw calls...
+		return true;
 	}
 
-	startIdxAdditiveDrawCalls = finalizedDrawCalls.size();
+	finalizedDrawCalls.clear();
+	startIdxTranslucentDrawCalls = 0;
+	startIdxAdditiveDrawCalls = 0;
 
-	for (const auto& mesh : instanceAdditiveMeshes)
+	if (instancesCount + translucentInstancesCount + additiveInstancesCount == 0)
 	{
-		const auto& meshInstances = mesh.second;
-		size_t startingIdxInInstancesBuffer = instancesData.size();
-		for (const auto& instance : meshInstances)
+		return true;
+	}
+
+	++finalizeSerial;
+	for (auto& batch : instanceBatches)
+	{
+		if (batch.queued.empty())
 		{
-			instancesData.push_back(GenerateInstanceData(instance.frame, instance.colour, instance.teamcolour, instance.flag, instance.flag_data, instance.modelMatrix, instance.stretch));
+			continue;
 		}
-		finalizedDrawCalls.emplace_back(mesh.first, meshInstances.size(), startingIdxInInstancesBuffer);
+		batch.lastUsedSerial = finalizeSerial;
+		if (batch.queued.size() > batch.slotCapacity)
+		{
+			instanceBatchLayoutDirty = true;
+		}
+	}
+	if (instanceBatchLayoutDirty)
+	{
+		layoutInstanceBatches();
 	}
 
-	// Upload buffer
-	++currInstanceBufferIdx;
-	if (currInstanceBufferIdx >= instanceDataBuffers.size())
+	for (size_t idx : sortedInstanceBatches)
 	{
-		currInstanceBufferIdx = 0;
+		InstanceBatch& batch = instanceBatches[idx];
+		if (batch.queued.empty())
+		{
+			continue;
+		}
+		for (size_t i = 0; i < batch.queued.size(); ++i)
+		{
+			const SHAPE& instance = batch.queued[i];
+			if (i < batch.slotShapes.size())
+			{
+				if (sameMeshInstance(batch.slotShapes[i], instance))
+				{
+					continue;
+				}
+				batch.slotShapes[i] = instance;
+			}
+			else
+			{
+				batch.slotShapes.push_back(instance);
+			}
+			const size_t slot = batch.firstSlot + i;
+			instancesData[slot] = GenerateInstanceData(instance.frame, instance.colour, instance.teamcolour, instance.flag, instance.flag_data, instance.modelMatrix, instance.stretch);
+			instanceSlotChangedSerial[slot] = finalizeSerial;
+			lastChangeSerial = finalizeSerial;
+		}
+		finalizedDrawCalls.emplace_back(batch.state, batch.queued.size(), batch.firstSlot);
+		if (batch.category == InstanceCategory::Opaque)
+		{
+			startIdxTranslucentDrawCalls = finalizedDrawCalls.size();
+		}
+		if (batch.category != InstanceCategory::Additive)
+		{
+			startIdxAdditiveDrawCalls = finalizedDrawCalls.size();
+		}
 	}
-	instanceDataBuffers[currInstanceBufferIdx]->upload(instancesData.size() * sizeof(gfx_api::Draw3DShapePerInstanceInterleavedData), instancesData.data());
 
-	instancesData.clear();
+	uploadInstanceData();
 
 	return true;
 }
@@ -118,6 +118,7 @@ enum SHADER_MODE
 	SHADER_GENERIC_COLOR,
 	SHADER_LINE,
 	SHADER_TEXT,
+	SHADER_TEXT_INSTANCED,
 	SHADER_TERRAIN_COMBINED_CLASSIC,
 	SHADER_TERRAIN_COMBINED_MEDIUM,
 	SHADER_TERRAIN_COMBINED_HIGH,
@@ -513,6 +513,222 @@ private:
 
 static FTCache* glyphCache = nullptr;
 
+#define GLYPH_ATLAS_PAGE_SIZE		1024
+#define GLYPH_ATLAS_MAX_PAGES		4
+#define GLYPH_ATLAS_PADDING		1 // transparent border around each glyph (prevents bilinear filtering bleeding from neighbouring glyphs)
+#define GLYPH_ATLAS_SUBPIXEL_STEP	16 // subpixel offsets (in 1/64 pixel units) are quantized to 1/4 pixel
+
+struct GlyphAtlasKey
+{
+	FTFace* face;
+	uint32_t codepoint;
+	Vector2i subpixeloffset64;
+
+	GlyphAtlasKey(FTFace& face, uint32_t codepoint, Vector2i subpixeloffset64)
+	: face(&face), codepoint(codepoint), subpixeloffset64(subpixeloffset64)
+	{ }
+
+	bool operator==(const GlyphAtlasKey &other) const
+	{
+		return face == other.face && codepoint == other.codepoint && subpixeloffset64 == other.subpixeloffset64;
+	}
+};
+
+namespace std {
+
+	template <>
+	struct hash<GlyphAtlasKey>
+	{
+		std::size_t operator()(const GlyphAtlasKey& k) const
+		{
+			return std::hash<FTFace*>()(k.face)
+				 ^ (std::hash<uint32_t>()(k.codepoint) << 1)
+				 ^ (std::hash<int>()((k.subpixeloffset64.x << 8) | (k.subpixeloffset64.y & 0xFF)) << 2);
+		}
+	};
+
+}
+
+struct GlyphAtlasEntry
+{
+	size_t page = 0;
+	Vector2i atlasPosition = Vector2i(0, 0); // top-left of the glyph (excluding padding) in the atlas page
+	Vector2i size = Vector2i(0, 0); // 0-sized glyphs (ex. spaces) have no atlas cell
+	int32_t bearing_x = 0;
+	int32_t bearing_y = 0;
+};
+
+// A shared texture atlas of rasterized glyphs, filled on-demand from the FTCache.
+// Glyphs are packed into fixed-size pages using a simple shelf allocator. When all pages are full, the
+// atlas is cleared and its generation incremented - anything referencing atlas cells must then be re-laid out.
+class GlyphAtlas
+{
+public:
+	GlyphAtlas()
+	: m_generation(nextGeneration())
+	{ }
+
+	~GlyphAtlas()
+	{
+		clear();
+	}
+
+	GlyphAtlasEntry get(FTFace& face, uint32_t codepoint, Vector2i subpixeloffset64)
+	{
+		subpixeloffset64 = (subpixeloffset64 / GLYPH_ATLAS_SUBPIXEL_STEP) * GLYPH_ATLAS_SUBPIXEL_STEP;
+		GlyphAtlasKey key(face, codepoint, subpixeloffset64);
+		auto it = m_entries.find(key);
+		if (it != m_entries.end())
+		{
+			return it->second;
+		}
+
+		RasterizedGlyph glyph = glyphCache->get(face, codepoint, subpixeloffset64);
+		GlyphAtlasEntry entry;
+		entry.size = Vector2i(glyph.width, glyph.height);
+		entry.bearing_x = glyph.bearing_x;
+		entry.bearing_y = glyph.bearing_y;
+
+		if (glyph.width > 0 && glyph.height > 0)
+		{
+			const Vector2i cellSize = entry.size + Vector2i(GLYPH_ATLAS_PADDING * 2, GLYPH_ATLAS_PADDING * 2);
+			Vector2i cellPosition;
+			if (!allocateCell(cellSize, entry.page, cellPosition))
+			{
+				debug(LOG_WZ, "Glyph atlas is full (%zu pages) - clearing", m_pages.size());
+				clear();
+				if (!allocateCell(cellSize, entry.page, cellPosition))
+				{
+					ASSERT(false, "Glyph (%" PRIu32 ") too large for the glyph atlas (%" PRIu32 " x %" PRIu32 ")", codepoint, glyph.width, glyph.height);
+					return GlyphAtlasEntry();
+				}
+			}
+			entry.atlasPosition = cellPosition + Vector2i(GLYPH_ATLAS_PADDING, GLYPH_ATLAS_PADDING);
+
+			// Convert the (LCD subpixel) glyph to RGBA, in the same way as the text was previously composited
+			iV_Image cellBitmap;
+			cellBitmap.allocate(cellSize.x, cellSize.y, 4, true);
+			unsigned char* cellData = cellBitmap.bmp_w();
+			for (uint32_t i = 0; i < glyph.height; ++i)
+			{
+				for (uint32_t j = 0; j < glyph.width; ++j)
+				{
+					uint8_t const *src = &glyph.buffer[i * glyph.pitch + 3 * j];
+					uint8_t *dst = &cellData[4 * ((i + GLYPH_ATLAS_PADDING) * cellSize.x + j + GLYPH_ATLAS_PADDING)];
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					dst[3] = static_cast<uint8_t>((src[0] * 77 + src[1] * 150 + src[2] * 29) >> 8);
+				}
+			}
+			m_pages[entry.page].texture->upload_sub(0, cellPosition.x, cellPosition.y, cellBitmap);
+		}
+
+		m_entries.emplace(key, entry);
+		return entry;
+	}
+
+	gfx_api::texture* pageTexture(size_t page) const
+	{
+		ASSERT_OR_RETURN(nullptr, page < m_pages.size(), "Invalid glyph atlas page: %zu", page);
+		return m_pages[page].texture;
+	}
+
+	uint32_t generation() const
+	{
+		return m_generation;
+	}
+
+	void clear()
+	{
+		for (auto& page : m_pages)
+		{
+			delete page.texture;
+		}
+		m_pages.clear();
+		m_entries.clear();
+		m_generation = nextGeneration();
+	}
+
+private:
+	// Generations are unique across atlas instances (the atlas is re-created when the text subsystem is re-initialized)
+	static uint32_t nextGeneration()
+	{
+		static uint32_t generationCounter = 0;
+		return ++generationCounter;
+	}
+
+	bool allocateCell(Vector2i cellSize, size_t& outPage, Vector2i& outPosition)
+	{
+		if (cellSize.x > GLYPH_ATLAS_PAGE_SIZE || cellSize.y > GLYPH_ATLAS_PAGE_SIZE)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < m_pages.size(); ++i)
+		{
+			if (m_pages[i].allocate(cellSize, outPosition))
+			{
+				outPage = i;
+				return true;
+			}
+		}
+		if (m_pages.size() >= GLYPH_ATLAS_MAX_PAGES)
+		{
+			return false;
+		}
+
+		// Start a new (cleared) page
+		iV_Image emptyPage;
+		emptyPage.allocate(GLYPH_ATLAS_PAGE_SIZE, GLYPH_ATLAS_PAGE_SIZE, 4, true);
+		Page page;
+		page.texture = gfx_api::context::get().createTextureForCompatibleImageUploads(1, emptyPage, "mem::glyphAtlas[" + std::to_string(m_pages.size()) + "]");
+		ASSERT_OR_RETURN(false, page.texture != nullptr, "Failed to create glyph atlas page");
+		page.texture->upload(0, emptyPage);
+		m_pages.push_back(page);
+
+		outPage = m_pages.size() - 1;
+		return m_pages.back().allocate(cellSize, outPosition);
+	}
+
+private:
+	struct Page
+	{
+		gfx_api::texture* texture = nullptr;
+		int32_t shelfX = 0;
+		int32_t shelfY = 0;
+		int32_t shelfHeight = 0;
+
+		bool allocate(Vector2i cellSize, Vector2i& outPosition)
+		{
+			int32_t x = shelfX;
+			int32_t y = shelfY;
+			int32_t height = shelfHeight;
+			if (x + cellSize.x > GLYPH_ATLAS_PAGE_SIZE)
+			{
+				// start a new shelf
+				y += height;
+				x = 0;
+				height = 0;
+			}
+			if (y + cellSize.y > GLYPH_ATLAS_PAGE_SIZE)
+			{
+				return false;
+			}
+			outPosition = Vector2i(x, y);
+			shelfX = x + cellSize.x;
+			shelfY = y;
+			shelfHeight = std::max(height, cellSize.y);
+			return true;
+		}
+	};
+
+	std::vector<Page> m_pages;
+	std::unordered_map<GlyphAtlasKey, GlyphAtlasEntry> m_entries;
+	uint32_t m_generation;
+};
+
+static GlyphAtlas* glyphAtlas = nullptr;
+
 struct TextRun
 {
 	int startOffset;
@@ -594,30 +810,13 @@ struct TextLayoutMetrics
 	uint32_t height;
 };
 
-struct RenderedText
+struct LayoutTextResult
 {
-	RenderedText(std::unique_ptr<iV_Image> &&_bitmap, int32_t _offset_x, int32_t _offset_y)
-	: bitmap(std::move(_bitmap)), offset_x(_offset_x), offset_y(_offset_y)
-	{ }
-
-	RenderedText() : bitmap(nullptr), offset_x(0), offset_y(0)
-	{ }
-
-	std::unique_ptr<iV_Image> bitmap;
-	int32_t offset_x;
-	int32_t offset_y;
-};
-
-struct DrawTextResult
-{
-	DrawTextResult(RenderedText &&_text, TextLayoutMetrics _layoutMetrics) : text(std::move(_text)), layoutMetrics(_layoutMetrics)
-	{ }
-
-	DrawTextResult()
-	{ }
-
-	RenderedText text;
+	std::vector<WzTextGlyphQuad> glyphQuads; // sorted by atlas page
+	Vector2i offsets = Vector2i(0, 0); // top-left of the text bounds (in pixels)
+	Vector2i dimensions = Vector2i(0, 0); // size of the text bounds (in pixels)
 	TextLayoutMetrics layoutMetrics;
+	uint32_t atlasGeneration = 0;
 };
 
 // Note:
@@ -772,14 +971,18 @@ struct TextShaper
 	}
 #endif
 
-	// Draws the text and returns the text buffer, width and height, etc *IN PIXELS*
-	DrawTextResult drawText(const WzString& text, iV_fonts fontID)
+	// Lays out the text as glyph quads in the shared glyph atlas, and returns the quads, text bounds, and layout metrics *IN PIXELS*
+	LayoutTextResult layoutText(const WzString& text, iV_fonts fontID)
 	{
 		ShapingResult shapingResult = shapeText(text, fontID);
 
+		LayoutTextResult result;
+		result.layoutMetrics = TextLayoutMetrics(shapingResult.x_advance / 64, shapingResult.y_advance / 64);
+		result.atlasGeneration = glyphAtlas->generation();
+
 		if (shapingResult.glyphes.empty())
 		{
-			return DrawTextResult(RenderedText(), TextLayoutMetrics(shapingResult.x_advance / 64, shapingResult.y_advance / 64));
+			return result;
 		}
 
 		int32_t min_x = 1000;
@@ -787,77 +990,57 @@ struct TextShaper
 		int32_t min_y = 1000;
 		int32_t max_y = -1000;
 
-		// build glyphes
-		struct glyphRaster
+		for (size_t attempt = 0; attempt < 2; ++attempt)
 		{
-			std::unique_ptr<unsigned char[]> buffer;
-			Vector2i pixelPosition;
-			Vector2i size;
-			uint32_t pitch;
+			min_x = 1000;
+			max_x = -1000;
+			min_y = 1000;
+			max_y = -1000;
+			result.glyphQuads.clear();
+			result.atlasGeneration = glyphAtlas->generation();
+
+			for (const auto& g : shapingResult.glyphes)
+			{
+				GlyphAtlasEntry glyph = glyphAtlas->get(g.face, g.codepoint, g.penPosition % 64);
+				int32_t x0 = g.penPosition.x / 64 + glyph.bearing_x;
+				int32_t y0 = g.penPosition.y / 64 - glyph.bearing_y;
+				min_x = std::min(x0, min_x);
+				max_x = std::max(x0 + glyph.size.x, max_x);
+				min_y = std::min(y0, min_y);
+				max_y = std::max(y0 + glyph.size.y, max_y);
+
+				if (glyph.size.x > 0 && glyph.size.y > 0)
+				{
+					WzTextGlyphQuad quad;
+					quad.atlasPage = glyph.page;
+					quad.position = Vector2i(x0 - GLYPH_ATLAS_PADDING, y0 - GLYPH_ATLAS_PADDING);
+					quad.size = glyph.size + Vector2i(GLYPH_ATLAS_PADDING * 2, GLYPH_ATLAS_PADDING * 2);
+					quad.atlasPosition = glyph.atlasPosition - Vector2i(GLYPH_ATLAS_PADDING, GLYPH_ATLAS_PADDING);
+					result.glyphQuads.push_back(quad);
+				}
+			}
 
-			glyphRaster(std::unique_ptr<unsigned char[]> &&b, Vector2i &&p, Vector2i &&s, uint32_t _pitch)
-				: buffer(std::move(b)), pixelPosition(p), size(s), pitch(_pitch) {}
-		};
+			if (result.atlasGeneration == glyphAtlas->generation())
+			{
+				break;
+			}
+			// The atlas filled up (and was cleared) part-way through this string - the earlier glyphs are gone, so lay it out again
+			ASSERT(attempt == 0, "String \"%s\" does not fit in the glyph atlas", text.toUtf8().c_str());
+		}
 
-		std::vector<glyphRaster> glyphs;
-		std::transform(shapingResult.glyphes.begin(), shapingResult.glyphes.end(), std::back_inserter(glyphs),
-			[&] (const HarfbuzzPosition &g) {
-			RasterizedGlyph glyph = glyphCache->get(g.face, g.codepoint, g.penPosition % 64);
-			int32_t x0 = g.penPosition.x / 64 + glyph.bearing_x;
-			int32_t y0 = g.penPosition.y / 64 - glyph.bearing_y;
-			min_x = std::min(x0, min_x);
-			max_x = std::max(static_cast<int32_t>(x0 + glyph.width), max_x);
-			min_y = std::min(y0, min_y);
-			max_y = std::max(static_cast<int32_t>(y0 + glyph.height), max_y);
-			return glyphRaster(std::move(glyph.buffer), Vector2i(x0, y0), Vector2i(glyph.width, glyph.height), glyph.pitch);
-			});
+		std::stable_sort(result.glyphQuads.begin(), result.glyphQuads.end(), [](const WzTextGlyphQuad& a, const WzTextGlyphQuad& b) {
+			return a.atlasPage < b.atlasPage;
+		});
 
 		const uint32_t texture_width = max_x - min_x + 1;
 		const uint32_t texture_height = max_y - min_y + 1;
 		const uint32_t x_advance = (shapingResult.x_advance / 64);
 		const uint32_t y_advance = (shapingResult.y_advance / 64);
 
-		if (texture_width == 0 || texture_height == 0)
-		{
-			return DrawTextResult(RenderedText(), TextLayoutMetrics(x_advance, y_advance));
-		}
-
-		std::unique_ptr<iV_Image> stringBitmap(new iV_Image());
-		stringBitmap->allocate(texture_width, texture_height, 4, true);
-		unsigned char* stringTexture = stringBitmap->bmp_w();
-		const size_t stringTextureSize = stringBitmap->data_size();
-
-		// TODO: Someone should document this piece.
-		size_t glyphNum = 0;
-		std::for_each(glyphs.begin(), glyphs.end(),
-			[&](const glyphRaster &g)
-			{
-				const auto glyphBufferSize = g.pitch * g.size.y;
-				for (int i = 0; i < g.size.y; ++i)
-				{
-					uint32_t i0 = g.pixelPosition.y - min_y;
-					for (int j = 0; j < g.size.x; ++j)
-					{
-						uint32_t j0 = g.pixelPosition.x - min_x;
-						const auto srcBufferPos = i * g.pitch + 3 * j;
-						ASSERT(srcBufferPos + 2 < glyphBufferSize, "Invalid source (%" PRIu32" / %" PRIu32") reading glyph %zu for string \"%s\"; (%d, %d, %d, %d, %" PRIu32 ", %d, %d, %d, %" PRIu32 ", %" PRIu32 ")", srcBufferPos, glyphBufferSize, glyphNum, text.toUtf8().c_str(), i, g.size.y, g.pixelPosition.y, min_y, i0, j, g.pixelPosition.x, min_x, j0, g.pitch);
-						uint8_t const *src = &g.buffer[srcBufferPos];
-						const auto stringTexturePos = 4 * ((i0 + i) * texture_width + j + j0);
-						ASSERT(stringTexturePos + 3 < stringTextureSize, "Invalid destination (%" PRIu32" / %zu) writing glyph %zu for string \"%s\"; (%d, %d, %d, %d, %" PRIu32 ", %d, %d, %d, %" PRIu32 ", %" PRIu32 ")", stringTexturePos, stringTextureSize, glyphNum, text.toUtf8().c_str(), i, g.size.y, g.pixelPosition.y, min_y, i0, j, g.pixelPosition.x, min_x, j0, texture_width);
-						uint8_t *dst = &stringTexture[stringTexturePos];
-						dst[0] = std::min(dst[0] + src[0], 255);
-						dst[1] = std::min(dst[1] + src[1], 255);
-						dst[2] = std::min(dst[2] + src[2], 255);
-						dst[3] = std::min(dst[3] + ((src[0] * 77 + src[1] * 150 + src[2] * 29) >> 8), 255);
-					}
-				}
-				++glyphNum;
-			});
-
-		return DrawTextResult(
-				RenderedText(std::move(stringBitmap), min_x, min_y),
-				TextLayoutMetrics(std::max(texture_width, x_advance), std::max(texture_height, y_advance))
-		);
+		result.offsets = Vector2i(min_x, min_y);
+		result.dimensions = Vector2i(texture_width, texture_height);
+		result.layoutMetrics = TextLayoutMetrics(std::max(texture_width, x_advance), std::max(texture_height, y_advance));
+		return result;
 	}
 
 	struct SplitTextRunsResult
@@ -1171,6 +1354,41 @@ struct iVFontsHash
 typedef std::unordered_map<iV_fonts, WzText, iVFontsHash> FontToEllipsisMapType;
 static FontToEllipsisMapType fontToEllipsisMap;
 
+// iV_DrawText / iV_DrawTextRotated callers are immediate-mode, so keep the WzText (and its instance buffer) of recently drawn strings
+#define DRAW_TEXT_CACHE_SIZE		64
+#define DRAW_TEXT_CACHE_ELASTICITY	16
+
+struct DrawTextCacheKey
+{
+	std::string text;
+	iV_fonts fontID;
+
+	DrawTextCacheKey(const char *text, iV_fonts fontID)
+	: text(text), fontID(fontID)
+	{ }
+
+	bool operator==(const DrawTextCacheKey& other) const
+	{
+		return fontID == other.fontID && text == other.text;
+	}
+};
+
+namespace std {
+
+	template <>
+	struct hash<DrawTextCacheKey>
+	{
+		std::size_t operator()(const DrawTextCacheKey& k) const
+		{
+			return std::hash<std::string>()(k.text)
+				 ^ (std::hash<int>()(static_cast<int>(k.fontID)) << 1);
+		}
+	};
+
+}
+
+static lru11::Cache<DrawTextCacheKey, WzText> drawTextCache(DRAW_TEXT_CACHE_SIZE, DRAW_TEXT_CACHE_ELASTICITY);
+
 #define CJK_FONT_PATH "fonts/NotoSansCJK-VF.otf.ttc"
 
 static bool inline initializeCJKFontsIfNeeded()
@@ -1256,8 +1474,6 @@ static FTFace &getFTFace(iV_fonts FontID, hb_script_t script)
 	}
 }
 
-static gfx_api::texture* textureID = nullptr;
-
 void iV_TextInit(unsigned int horizScalePercentage, unsigned int vertScalePercentage)
 {
 	if (horizScalePercentage > 100 && horizScalePercentage < 200)
@@ -1285,6 +1501,11 @@ void iV_TextInit(unsigned int horizScalePercentage, unsigned int vertScalePercen
 		glyphCache = new FTCache();
 	}
 
+	if (glyphAtlas == nullptr)
+	{
+		glyphAtlas = new GlyphAtlas();
+	}
+
 	if (baseFonts == nullptr)
 	{
 		baseFonts = new WZFontCollection();
@@ -1334,6 +1555,11 @@ void iV_TextInit(unsigned int horizScalePercentage, unsigned int vertScalePercen
 
 void iV_TextShutdown()
 {
+	// Clear the ellipsis and iV_DrawText caches first (they hold WzText instances that reference the glyph atlas)
+	fontToEllipsisMap.clear();
+	drawTextCache.clear();
+	delete glyphAtlas;
+	glyphAtlas = nullptr;
 	glyphCache->clear();
 	delete glyphCache;
 	glyphCache = nullptr;
@@ -1341,9 +1567,6 @@ void iV_TextShutdown()
 	baseFonts = nullptr;
 	delete cjkFonts;
 	cjkFonts = nullptr;
-	delete textureID;
-	textureID = nullptr;
-	fontToEllipsisMap.clear();
 	clearFontDataCache();
 	bLoadedTextSystem = false;
 }
@@ -1700,27 +1923,21 @@ void iV_DrawTextRotated(const char* string, float XPos, float YPos, float rotati
 {
 	ASSERT_OR_RETURN(, string, "Couldn't render string!");
 
-	if (rotation != 0.f)
-	{
-		rotation = 180.f - rotation;
-	}
-
 	PIELIGHT color;
 	color.vector[0] = static_cast<UBYTE>(font_colour[0] * 255.f);
 	color.vector[1] = static_cast<UBYTE>(font_colour[1] * 255.f);
 	color.vector[2] = static_cast<UBYTE>(font_colour[2] * 255.f);
 	color.vector[3] = static_cast<UBYTE>(font_colour[3] * 255.f);
 
-	DrawTextResult drawResult = getShaper().drawText(string, fontID);
-
-	if (drawResult.text.bitmap && drawResult.text.bitmap->width() > 0 && drawResult.text.bitmap->height() > 0)
+	DrawTextCacheKey key(string, fontID);
+	WzText *pText = drawTextCache.tryGetPt(key);
+	if (pText == nullptr)
 	{
-		if (textureID)
-			delete textureID;
-		textureID = gfx_api::context::get().createTextureForCompatibleImageUploads(1, *(drawResult.text.bitmap.get()), std::string("text::") + string);
-		textureID->upload(0u, *(drawResult.text.bitmap.get()));
-		iV_DrawImageText(*textureID, Vector2f(XPos, YPos), Vector2f((float)drawResult.text.offset_x / _horizScaleFactor, (float)drawResult.text.offset_y / _vertScaleFactor), Vector2f((float)drawResult.text.bitmap->width() / _horizScaleFactor, (float)drawResult.text.bitmap->height() / _vertScaleFactor), rotation, color);
+		drawTextCache.insert(key, WzText(string, fontID));
+		pText = drawTextCache.tryGetPt(key);
+		ASSERT_OR_RETURN(, pText != nullptr, "Failed to cache text");
 	}
+	pText->render(Vector2f(XPos, YPos), color, rotation);
 }
 
 int WzText::width()
@@ -1773,22 +1990,14 @@ void WzText::drawAndCacheText(const WzString& string, iV_fonts fontID)
 	mPtsLineSize = metricsHeight_PixelsToPoints((type->size->metrics.ascender - type->size->metrics.descender) >> 6);
 	mPtsBelowBase = metricsHeight_PixelsToPoints(type->size->metrics.descender >> 6);
 
-	DrawTextResult drawResult = getShaper().drawText(string, fontID);
-	dimensions = (drawResult.text.bitmap) ? Vector2i(drawResult.text.bitmap->width(), drawResult.text.bitmap->height()) : Vector2i(0,0);
-	offsets = Vector2i(drawResult.text.offset_x, drawResult.text.offset_y);
-	layoutMetrics = Vector2i(drawResult.layoutMetrics.width, drawResult.layoutMetrics.height);
-
-	if (texture)
-	{
-		delete texture;
-		texture = nullptr;
-	}
+	LayoutTextResult layoutResult = getShaper().layoutText(string, fontID);
+	glyphQuads = std::move(layoutResult.glyphQuads);
+	mAtlasGeneration = layoutResult.atlasGeneration;
+	dimensions = layoutResult.dimensions;
+	offsets = layoutResult.offsets;
+	layoutMetrics = Vector2i(layoutResult.layoutMetrics.width, layoutResult.layoutMetrics.height);
 
-	if (dimensions.x > 0 && dimensions.y > 0)
-	{
-		texture = gfx_api::context::get().createTextureForCompatibleImageUploads(1, *(drawResult.text.bitmap.get()), std::string("text::") + string.toUtf8());
-		texture->upload(0u, *(drawResult.text.bitmap.get()));
-	}
+	releaseInstanceData();
 }
 
 void WzText::redrawAndCacheText()
@@ -1796,6 +2005,15 @@ void WzText::redrawAndCacheText()
 	drawAndCacheText(mText, mFontID);
 }
 
+void WzText::releaseInstanceData()
+{
+	delete instanceBuffer;
+	instanceBuffer = nullptr;
+	instanceBufferPageRanges.clear();
+	instanceDataClippingRect.reset();
+	instanceDataValid = false;
+}
+
 WzText::WzText(const WzString &string, iV_fonts fontID)
 {
 	setText(string, fontID);
@@ -1803,24 +2021,25 @@ WzText::WzText(const WzString &string, iV_fonts fontID)
 
 WzText::~WzText()
 {
-	if (texture)
-		delete texture;
+	releaseInstanceData();
 }
 
 WzText& WzText::operator=(WzText&& other)
 {
 	if (this != &other)
 	{
-		// Free the existing texture, if any.
-		if (texture)
-		{
-			delete texture;
-		}
+		// Free the existing instance data, if any.
+		releaseInstanceData();
 
 		// Get the other data
-		texture = other.texture;
 		mFontID = other.mFontID;
 		mText = std::move(other.mText);
+		glyphQuads = std::move(other.glyphQuads);
+		mAtlasGeneration = other.mAtlasGeneration;
+		instanceBuffer = other.instanceBuffer;
+		instanceBufferPageRanges = std::move(other.instanceBufferPageRanges);
+		instanceDataClippingRect = other.instanceDataClippingRect;
+		instanceDataValid = other.instanceDataValid;
 		mPtsAboveBase = other.mPtsAboveBase;
 		mPtsBelowBase = other.mPtsBelowBase;
 		mPtsLineSize = other.mPtsLineSize;
@@ -1830,8 +2049,9 @@ WzText& WzText::operator=(WzText&& other)
 		mRenderingVertScaleFactor = other.mRenderingVertScaleFactor;
 		layoutMetrics = other.layoutMetrics;
 
-		// Reset other's texture
-		other.texture = nullptr;
+		// Reset other's instance data
+		other.instanceBuffer = nullptr;
+		other.instanceDataValid = false;
 	}
 	return *this;
 }
@@ -1853,15 +2073,80 @@ inline void WzText::updateCacheIfNecessary()
 		redrawAndCacheText();
 		// debug(LOG_WZ, "Redrawing / re-calculating WzText text - scale factor has changed.");
 	}
+	else if (glyphAtlas && mAtlasGeneration != glyphAtlas->generation())
+	{
+		// The glyph atlas has been cleared, so the glyphs must be re-added to it.
+		redrawAndCacheText();
+	}
+}
+
+// Clips a glyph quad (in text pixel space) to the clipping rect, and calculates its glyph atlas texture coordinates
+static bool clipGlyphQuad(const WzTextGlyphQuad& quad, const optional<WzRect>& clippingRect, Vector2f& outPosition, Vector2f& outSize, Vector2f& outUVOffset, Vector2f& outUVSize)
+{
+	Vector2i topLeft = quad.position;
+	Vector2i bottomRight = quad.position + quad.size;
+	if (clippingRect.has_value())
+	{
+		topLeft = Vector2i(std::max(topLeft.x, clippingRect->left()), std::max(topLeft.y, clippingRect->top()));
+		bottomRight = Vector2i(std::min(bottomRight.x, clippingRect->right()), std::min(bottomRight.y, clippingRect->bottom()));
+		if (topLeft.x >= bottomRight.x || topLeft.y >= bottomRight.y)
+		{
+			return false;
+		}
+	}
+
+	const float invPageSize = 1.f / static_cast<float>(GLYPH_ATLAS_PAGE_SIZE);
+	outPosition = Vector2f(topLeft.x, topLeft.y);
+	outSize = Vector2f(bottomRight.x - topLeft.x, bottomRight.y - topLeft.y);
+	outUVOffset = Vector2f(quad.atlasPosition.x + (topLeft.x - quad.position.x), quad.atlasPosition.y + (topLeft.y - quad.position.y)) * invPageSize;
+	outUVSize = outSize * invPageSize;
+	return true;
+}
+
+void WzText::updateInstanceData(const optional<WzRect>& clippingRectInPixels)
+{
+	if (instanceDataValid && instanceDataClippingRect == clippingRectInPixels)
+	{
+		return; // cached
+	}
+
+	std::vector<gfx_api::TextGlyphPerInstanceInterleavedData> instances;
+	instances.reserve(glyphQuads.size());
+	instanceBufferPageRanges.clear();
+	for (const auto& quad : glyphQuads)
+	{
+		Vector2f position, size, uvOffset, uvSize;
+		if (!clipGlyphQuad(quad, clippingRectInPixels, position, size, uvOffset, uvSize))
+		{
+			continue;
+		}
+		if (instanceBufferPageRanges.empty() || instanceBufferPageRanges.back().first != quad.atlasPage)
+		{
+			instanceBufferPageRanges.emplace_back(quad.atlasPage, 0);
+		}
+		++(instanceBufferPageRanges.back().second);
+		instances.emplace_back(glm::vec4(position.x, position.y, size.x, size.y), glm::vec4(uvOffset.x, uvOffset.y, uvSize.x, uvSize.y));
+	}
+
+	// Always use a new buffer (the existing one may already have been drawn from in the current frame)
+	delete instanceBuffer;
+	instanceBuffer = nullptr;
+	if (!instances.empty())
+	{
+		instanceBuffer = gfx_api::context::get().create_buffer_object(gfx_api::buffer::usage::vertex_buffer, gfx_api::context::buffer_storage_hint::static_draw, "WzText::instanceBuffer");
+		instanceBuffer->upload(instances.size() * sizeof(gfx_api::TextGlyphPerInstanceInterleavedData), instances.data());
+	}
+	instanceDataClippingRect = clippingRectInPixels;
+	instanceDataValid = true;
 }
 
 void WzText::render(Vector2f position, PIELIGHT colour, float rotation, int maxWidth, int maxHeight)
 {
 	updateCacheIfNecessary();
 
-	if (texture == nullptr)
+	if (glyphQuads.empty() || glyphAtlas == nullptr)
 	{
-		// A texture will not always be created. (For example, if the rendered text is empty.)
+		// There will not always be glyphs to draw. (For example, if the rendered text is empty.)
 		// No need to render if there's nothing to render.
 		return;
 	}
@@ -1871,16 +2156,52 @@ void WzText::render(Vector2f position, PIELIGHT colour, float rotation, int maxW
 		rotation = 180.f - rotation;
 	}
 
-	if (maxWidth <= 0 && maxHeight <= 0)
+	optional<WzRect> clippingRectInPixels;
+	if (maxWidth > 0 || maxHeight > 0)
 	{
-		iV_DrawImageText(*texture, position, Vector2f(offsets.x / mRenderingHorizScaleFactor, offsets.y / mRenderingVertScaleFactor), Vector2f(dimensions.x / mRenderingHorizScaleFactor, dimensions.y / mRenderingVertScaleFactor), rotation, colour);
+		// The clipping rect is relative to the top-left of the text bounds
+		clippingRectInPixels = WzRect(offsets.x, offsets.y,
+			(maxWidth > 0) ? static_cast<int>((float)maxWidth * mRenderingHorizScaleFactor) : dimensions.x,
+			(maxHeight > 0) ? static_cast<int>((float)maxHeight * mRenderingVertScaleFactor) : dimensions.y);
+	}
+
+	const Vector2f scale(1.f / mRenderingHorizScaleFactor, 1.f / mRenderingVertScaleFactor);
+
+	if (gfx_api::context::get().supportsInstancedRendering())
+	{
+		// One draw call per glyph atlas page (usually just one)
+		updateInstanceData(clippingRectInPixels);
+		if (instanceBuffer == nullptr)
+		{
+			return;
+		}
+		size_t instanceOffset = 0;
+		for (const auto& pageRange : instanceBufferPageRanges)
+		{
+			gfx_api::texture* pageTexture = glyphAtlas->pageTexture(pageRange.first);
+			if (pageTexture)
+			{
+				iV_DrawImageTextInstanced(*pageTexture, *instanceBuffer, instanceOffset * sizeof(gfx_api::TextGlyphPerInstanceInterleavedData), pageRange.second, position, scale, rotation, colour);
+			}
+			instanceOffset += pageRange.second;
+		}
 	}
 	else
 	{
-		WzRect clippingRectInPixels;
-		clippingRectInPixels.setWidth((maxWidth > 0) ? static_cast<int>((float)maxWidth * mRenderingHorizScaleFactor) : dimensions.x);
-		clippingRectInPixels.setHeight((maxHeight > 0) ? static_cast<int>((float)maxHeight * mRenderingVertScaleFactor) : dimensions.y);
-		iV_DrawImageTextClipped(*texture, dimensions, position, Vector2f(offsets.x / mRenderingHorizScaleFactor, offsets.y / mRenderingVertScaleFactor), Vector2f((maxWidth > 0) ? maxWidth : dimensions.x / mRenderingHorizScaleFactor, (maxHeight > 0) ? maxHeight : dimensions.y / mRenderingVertScaleFactor), rotation, colour, clippingRectInPixels);
+		// Fallback: one draw call per glyph
+		for (const auto& quad : glyphQuads)
+		{
+			Vector2f quadPosition, quadSize, uvOffset, uvSize;
+			if (!clipGlyphQuad(quad, clippingRectInPixels, quadPosition, quadSize, uvOffset, uvSize))
+			{
+				continue;
+			}
+			gfx_api::texture* pageTexture = glyphAtlas->pageTexture(quad.atlasPage);
+			if (pageTexture)
+			{
+				iV_DrawImageTextRegion(*pageTexture, position, quadPosition * scale, quadSize * scale, uvOffset, uvSize, rotation, colour);
+			}
+		}
 	}
 }
 
@@ -26,6 +26,7 @@
 
 #include "lib/framework/vector.h"
 #include "lib/framework/wzstring.h"
+#include "lib/framework/geometry.h"
 #include "gfx_api.h"
 #include "pietypes.h"
 
@@ -46,6 +47,15 @@ enum iV_fonts
 	font_count
 };
 
+// A single glyph of a WzText, referencing a cell in the shared glyph atlas
+struct WzTextGlyphQuad
+{
+	size_t atlasPage = 0;
+	Vector2i position = Vector2i(0, 0); // in pixels, relative to the text origin
+	Vector2i size = Vector2i(0, 0); // in pixels
+	Vector2i atlasPosition = Vector2i(0, 0); // in pixels
+};
+
 class WzText
 {
 public:
@@ -78,9 +88,16 @@ private:
 	void drawAndCacheText(const WzString &text, iV_fonts fontID);
 	void redrawAndCacheText();
 	void updateCacheIfNecessary();
+	void updateInstanceData(const optional<WzRect>& clippingRectInPixels);
+	void releaseInstanceData();
 private:
 	WzString mText;
-	gfx_api::texture* texture = nullptr;
+	std::vector<WzTextGlyphQuad> glyphQuads; // sorted by atlas page
+	uint32_t mAtlasGeneration = 0;
+	gfx_api::buffer* instanceBuffer = nullptr;
+	std::vector<std::pair<size_t, size_t>> instanceBufferPageRanges; // (atlas page, instance count) in instanceBuffer order
+	optional<WzRect> instanceDataClippingRect;
+	bool instanceDataValid = false;
 	int mPtsAboveBase = 0;
 	int mPtsBelowBase = 0;
 	int mPtsLineSize = 0;
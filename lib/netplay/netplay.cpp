@@ -42,6 +42,7 @@
 #include <thread>
 #include <atomic>
 #include <limits>
+#include <algorithm>
 #include <sodium.h>
 
 #include "netplay.h"
@@ -316,6 +317,7 @@ static NETSTATS nStatsLastSec       = {{0, 0}, {0, 0}, {0, 0}};
 static NETSTATS nStatsSecondLastSec = {{0, 0}, {0, 0}, {0, 0}};
 static const NETSTATS nZeroStats    = {{0, 0}, {0, 0}, {0, 0}};
 static int nStatsLastUpdateTime = 0;
+static NETSTATS nPlayerStats[MAX_CONNECTED_PLAYERS];  ///< Running totals for the direct connection to each player slot.
 
 unsigned NET_PlayerConnectionStatus[CONNECTIONSTATUS_NORMAL][MAX_CONNECTED_PLAYERS];
 std::vector<optional<uint32_t>>	NET_waitingForIndexChangeAckSince = std::vector<optional<uint32_t>>(MAX_CONNECTED_PLAYERS, nullopt);	///< If waiting for the client to acknowledge a player index change, this is the realTime we started waiting
@@ -533,7 +535,7 @@ bool NETsetAsyncJoinApprovalResult(const std::string& uniqueJoinID, AsyncJoinApp
 
 // *********** Socket with buffer that read NETMSGs ******************
 
-static size_t NET_fillBuffer(Socket **pSocket, SocketSet *pSocketSet, uint8_t *bufstart, int bufsize)
+static size_t NET_fillBuffer(Socket **pSocket, SocketSet *pSocketSet, uint8_t *bufstart, int bufsize, uint32_t player)
 {
 	Socket *socket = *pSocket;
 	ssize_t size;
@@ -551,6 +553,12 @@ static size_t NET_fillBuffer(Socket **pSocket, SocketSet *pSocketSet, uint8_t *b
 		nStats.rawBytes.received          += rawBytes;
 		nStats.uncompressedBytes.received += size;
 		nStats.packets.received           += 1;
+		if (player < MAX_CONNECTED_PLAYERS)
+		{
+			nPlayerStats[player].rawBytes.received          += rawBytes;
+			nPlayerStats[player].uncompressedBytes.received += size;
+			nPlayerStats[player].packets.received           += 1;
+		}
 
 		return size;
 	}
@@ -1576,6 +1584,7 @@ int NETshutdown()
 	nStats = nZeroStats;
 	nStatsLastSec = nZeroStats;
 	nStatsSecondLastSec = nZeroStats;
+	std::fill(std::begin(nPlayerStats), std::end(nPlayerStats), nZeroStats);
 
 	return 0;
 }
@@ -1693,6 +1702,21 @@ size_t NETgetStatistic(NetStatisticType type, bool sent, bool isTotal)
 	return nStatsLastSec.*statsType.*statisticType - nStatsSecondLastSec.*statsType.*statisticType;
 }
 
+// ////////////////////////////////////////////////////////////////////////
+// return total bytes / packets exchanged over the direct connection to a player.
+size_t NETgetPlayerStatistic(uint32_t player, NetStatisticType type, bool sent)
+{
+	ASSERT_OR_RETURN(0, player < MAX_CONNECTED_PLAYERS, "Invalid player: %" PRIu32, player);
+	size_t Statistic::*statisticType = sent ? &Statistic::sent : &Statistic::received;
+	switch (type)
+	{
+	case NetStatisticRawBytes:          return nPlayerStats[player].rawBytes.*statisticType;
+	case NetStatisticUncompressedBytes: return nPlayerStats[player].uncompressedBytes.*statisticType;
+	case NetStatisticPackets:           return nPlayerStats[player].packets.*statisticType;
+	default: ASSERT(false, " "); return 0;
+	}
+}
+
 static std::set<uint32_t> netSendPendingDisconnectPlayerIndexes;
 
 void NETsendProcessDelayedActions()
@@ -1776,6 +1800,12 @@ bool NETsend(NETQUEUE queue, NetMessage const *message)
 					nStats.rawBytes.sent          += compressedRawLen;
 					nStats.uncompressedBytes.sent += rawLen;
 					nStats.packets.sent           += 1;
+					if (!isTmpQueue)
+					{
+						nPlayerStats[player].rawBytes.sent          += compressedRawLen;
+						nPlayerStats[player].uncompressedBytes.sent += rawLen;
+						nPlayerStats[player].packets.sent           += 1;
+					}
 				}
 				else if (result == SOCKET_ERROR)
 				{
@@ -1806,6 +1836,9 @@ bool NETsend(NETQUEUE queue, NetMessage const *message)
 				nStats.rawBytes.sent          += compressedRawLen;
 				nStats.uncompressedBytes.sent += rawLen;
 				nStats.packets.sent           += 1;
+				nPlayerStats[player].rawBytes.sent          += compressedRawLen;
+				nPlayerStats[player].uncompressedBytes.sent += rawLen;
+				nPlayerStats[player].packets.sent           += 1;
 			}
 			else if (result == SOCKET_ERROR)
 			{
@@ -1857,6 +1890,7 @@ void NETflush()
 			{
 				socketFlush(*connected_bsocket[player], player, &compressedRawLen);
 				nStats.rawBytes.sent += compressedRawLen;
+				nPlayerStats[player].rawBytes.sent += compressedRawLen;
 			}
 		}
 		for (int player = 0; player < MAX_TMP_SOCKETS; ++player)
@@ -1875,6 +1909,10 @@ void NETflush()
 		{
 			socketFlush(*bsocket, NetPlay.hostPlayer, &compressedRawLen);
 			nStats.rawBytes.sent += compressedRawLen;
+			if (NetPlay.hostPlayer < MAX_CONNECTED_PLAYERS)
+			{
+				nPlayerStats[NetPlay.hostPlayer].rawBytes.sent += compressedRawLen;
+			}
 		}
 	}
 }
@@ -1898,6 +1936,7 @@ static bool swapPlayerIndexes(uint32_t playerIndexA, uint32_t playerIndexB)
 
 	// Then swap the networking stuff for these slots
 	std::swap(connected_bsocket[playerIndexA], connected_bsocket[playerIndexB]);
+	std::swap(nPlayerStats[playerIndexA], nPlayerStats[playerIndexB]);
 	// should be no need to call SocketSet_AddSocket, since should already be in the socket_set
 	NETswapQueues(NETnetQueue(playerIndexA), NETnetQueue(playerIndexB));
 
@@ -2856,7 +2895,7 @@ bool NETrecvNet(NETQUEUE *queue, uint8_t *type)
 			continue;
 		}
 
-		dataLen = NET_fillBuffer(pSocket, sset, buffer, sizeof(buffer));
+		dataLen = NET_fillBuffer(pSocket, sset, buffer, sizeof(buffer), current);
 		if (dataLen > 0)
 		{
 			// we received some data, add to buffer
@@ -3782,6 +3821,7 @@ static void NEThostPromoteTempSocketToPermanentPlayerConnection(unsigned int tem
 	NET_waitingForIndexChangeAckSince[index] = nullopt;
 	SocketSet_AddSocket(*server_socket_set, connected_bsocket[index]);
 	NETmoveQueue(NETnetTmpQueue(tempSocketIdx), NETnetQueue(index));
+	nPlayerStats[index] = nZeroStats;
 
 	// Copy player's IP address
 	sstrcpy(NetPlay.players[index].IPtextAddress, rIP.c_str());
@@ -377,6 +377,7 @@ void NETinitPortMapping();
 
 enum NetStatisticType {NetStatisticRawBytes, NetStatisticUncompressedBytes, NetStatisticPackets};
 size_t NETgetStatistic(NetStatisticType type, bool sent, bool isTotal = false);     // Return some statistic. Call regularly for good results.
+size_t NETgetPlayerStatistic(uint32_t player, NetStatisticType type, bool sent);    // Return the running total of some statistic for the direct connection to a player.
 
 void NETplayerKicked(UDWORD index);			// Cleanup after player has been kicked
 
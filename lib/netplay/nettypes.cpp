@@ -411,6 +411,17 @@ bool NETgameIsBehindPlayersByAtLeast(size_t numGameTimeUpdates /*= 2*/)
 	return true;  // Have enough pending game time updates from all players that should be waited on
 }
 
+size_t NETgetPendingGameTimeUpdates(unsigned player)
+{
+	ASSERT_OR_RETURN(0, player < MAX_CONNECTED_PLAYERS, "Invalid player: %u", player);
+	auto pPlayerGameQueue = gameQueues[player];
+	if (!pPlayerGameQueue)
+	{
+		return 0;
+	}
+	return pPlayerGameQueue->numPendingGameTimeUpdateMessages();
+}
+
 NETQUEUE NETgameQueueForced(unsigned player)
 {
 	NETQUEUE ret;
@@ -235,5 +235,6 @@ bool NETisReplay();
 void NETshutdownReplay();
 
 bool NETgameIsBehindPlayersByAtLeast(size_t numGameTimeUpdates = 2);
+size_t NETgetPendingGameTimeUpdates(unsigned player);  ///< Number of GAME_GAME_TIME updates queued in the player's game queue, but not yet processed.
 
 #endif
@@ -68,6 +68,8 @@
 #define TARGET_DOOMED_PENALTY_F		10	// Targets that have a lot of damage incoming are less attractive
 #define TARGET_DOOMED_SLOW_RELOAD_T	21	// Weapon ROF threshold for above penalty. per minute.
 
+#define STRUCT_MIN_TARGET_VALUE		-1	// Structures never choose targets that targetAttackWeight() values below this
+
 //Some weights for the units attached to a commander
 #define	WEIGHT_CMD_RANK				(WEIGHT_DIST_TILE * 4)			//A single rank is as important as 4 tiles distance
 #define	WEIGHT_CMD_SAME_TARGET		WEIGHT_DIST_TILE				//Don't want this to be too high, since a commander can have many units assigned
@@ -101,8 +103,8 @@ static int aiDroidRange(DROID *psDroid, int weapon_slot)
 	return longRange;
 }
 
-// see if a structure has the range to fire on a target
-static bool aiStructHasRange(STRUCTURE *psStruct, BASE_OBJECT *psTarget, int weapon_slot)
+// see if a target is within a structure's weapon range, ignoring line of fire
+static bool aiStructInRange(STRUCTURE *psStruct, BASE_OBJECT *psTarget, int weapon_slot)
 {
 	if (psStruct->numWeaps == 0 || psStruct->asWeaps[0].nStat == 0)
 	{
@@ -113,7 +115,13 @@ static bool aiStructHasRange(STRUCTURE *psStruct, BASE_OBJECT *psTarget, int wea
 	WEAPON_STATS *psWStats = psStruct->getWeaponStats(weapon_slot);
 
 	int longRange = proj_GetLongRange(*psWStats, psStruct->player);
-	return objPosDiffSq(psStruct, psTarget) < longRange * longRange && lineOfFire(psStruct, psTarget, weapon_slot, true);
+	return objPosDiffSq(psStruct, psTarget) < longRange * longRange;
+}
+
+// see if a structure has the range to fire on a target
+static bool aiStructHasRange(STRUCTURE *psStruct, BASE_OBJECT *psTarget, int weapon_slot)
+{
+	return aiStructInRange(psStruct, psTarget, weapon_slot) && lineOfFire(psStruct, psTarget, weapon_slot, true);
 }
 
 static bool aiDroidHasRange(DROID *psDroid, BASE_OBJECT *psTarget, int weapon_slot)
@@ -937,8 +945,12 @@ bool aiChooseTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget, int weapon_slot
 
 		if (psTarget == nullptr && !bCommanderBlock)
 		{
-			int targetValue = -1;
-			int tarDist = INT32_MAX;
+			struct Candidate
+			{
+				BASE_OBJECT *psObj;
+				int value;
+				int distSq;
+			};
 			int srange = longRange;
 
 			if (!proj_Direct(psWStats) && srange > objSensorRange(psObj))
@@ -948,6 +960,10 @@ bool aiChooseTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget, int weapon_slot
 				srange = objSensorRange(psObj);
 			}
 
+			// Gather the targets in range first, and only trace lines of fire from the best one down,
+			// since that is far more expensive than the other checks.
+			static std::vector<Candidate> candidates;  // static to avoid allocations.
+			candidates.clear();
 			static GridList gridList;  // static to avoid allocations.
 			gridList = gridStartIterate(psObj->pos.x, psObj->pos.y, srange);
 			for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
@@ -957,20 +973,35 @@ bool aiChooseTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget, int weapon_slot
 				if (psCurr->type != OBJ_FEATURE && !psCurr->died
 				    && !aiCheckAlliances(psCurr->player, psObj->player)
 				    && validTarget(psObj, psCurr, weapon_slot) && psCurr->visible[psObj->player] == UBYTE_MAX
-				    && aiStructHasRange((STRUCTURE *)psObj, psCurr, weapon_slot))
+				    && aiStructInRange((STRUCTURE *)psObj, psCurr, weapon_slot))
 				{
 					int newTargetValue = targetAttackWeight(psCurr, psObj, weapon_slot);
 					// See if in sensor range and visible
 					int distSq = objPosDiffSq(psCurr->pos, psObj->pos);
-					if (newTargetValue < targetValue || (newTargetValue == targetValue && distSq >= tarDist))
+					// Structures ignore targets that targetAttackWeight() rates below STRUCT_MIN_TARGET_VALUE
+					if (newTargetValue < STRUCT_MIN_TARGET_VALUE)
 					{
 						continue;
 					}
+					candidates.push_back({psCurr, newTargetValue, distSq});
+				}
+			}
 
-					tmpOrigin = ORIGIN_VISUAL;
-					psTarget = psCurr;
-					tarDist = distSq;
-					targetValue = newTargetValue;
+			// Highest value first, then nearest, otherwise in grid order.
+			std::stable_sort(candidates.begin(), candidates.end(), [](Candidate const &a, Candidate const &b) {
+				return a.value != b.value ? a.value > b.value : a.distSq < b.distSq;
+			});
+			if (!candidates.empty())
+			{
+				LineOfFireChecker hasLineOfFire(psObj, weapon_slot, true);
+				for (Candidate const &candidate : candidates)
+				{
+					if (hasLineOfFire(candidate.psObj))
+					{
+						tmpOrigin = ORIGIN_VISUAL;
+						psTarget = candidate.psObj;
+						break;
+					}
 				}
 			}
 		}
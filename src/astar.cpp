@@ -213,6 +213,12 @@ struct PathfindContext
 /// Last recently used list of contexts.
 static std::list<PathfindContext> fpathContexts;
 
+/// Last recently used list of flow fields: contexts explored from a destination to every tile that can reach it.
+/// Built once for a large group of droids sent to the same place in the same tick, see PATHJOB::flowField.
+static std::list<PathfindContext> fpathFlowFields;
+/// Maximum number of flow fields in fpathFlowFields.
+#define FLOWFIELD_MAX 4
+
 /// Lists of blocking maps from current tick.
 static std::vector<std::shared_ptr<PathBlockingMap>> fpathBlockingMaps;
 /// Game time for all blocking maps in fpathBlockingMaps.
@@ -235,6 +241,7 @@ static const Vector2i aDirOffset[] =
 void fpathHardTableReset()
 {
 	fpathContexts.clear();
+	fpathFlowFields.clear();
 	fpathBlockingMaps.clear();
 }
 
@@ -352,6 +359,55 @@ static void fpathAStarReestimate(PathfindContext &context, PathCoord tileF)
 	std::make_heap(context.nodes.begin(), context.nodes.end());
 }
 
+/// Adds the accessible neighbours of a visited node to the open list.
+static void fpathAStarExpand(PathfindContext &context, PathCoord tileF, PathNode const &node)
+{
+	// loop through possible moves in 8 directions to find a valid move
+	for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
+	{
+		// Try a new location
+		int x = node.p.x + aDirOffset[dir].x;
+		int y = node.p.y + aDirOffset[dir].y;
+
+		/*
+		   5  6  7
+		     \|/
+		   4 -I- 0
+		     /|\
+		   3  2  1
+		   odd:orthogonal-adjacent tiles even:non-orthogonal-adjacent tiles
+		*/
+		if (dir % 2 != 0 && !context.dstIgnore.isNonblocking(node.p.x, node.p.y) && !context.dstIgnore.isNonblocking(x, y))
+		{
+			int x2, y2;
+
+			// We cannot cut corners
+			x2 = node.p.x + aDirOffset[(dir + 1) % 8].x;
+			y2 = node.p.y + aDirOffset[(dir + 1) % 8].y;
+			if (context.isBlocked(x2, y2))
+			{
+				continue;
+			}
+			x2 = node.p.x + aDirOffset[(dir + 7) % 8].x;
+			y2 = node.p.y + aDirOffset[(dir + 7) % 8].y;
+			if (context.isBlocked(x2, y2))
+			{
+				continue;
+			}
+		}
+
+		// See if the node is a blocking tile
+		if (context.isBlocked(x, y))
+		{
+			// tile is blocked, skip it
+			continue;
+		}
+
+		// Now insert the point into the appropriate list, if not already visited.
+		fpathNewNode(context, tileF, PathCoord(x, y), node.dist, node.p);
+	}
+}
+
 /// Returns nearest explored tile to tileF.
 static PathCoord fpathAStarExplore(PathfindContext &context, PathCoord tileF)
 {
@@ -383,50 +439,7 @@ static PathCoord fpathAStarExplore(PathfindContext &context, PathCoord tileF)
 			foundIt = true;  // Break out of loop, but not before inserting neighbour nodes, since the neighbours may be important if the context gets reused.
 		}
 
-		// loop through possible moves in 8 directions to find a valid move
-		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
-		{
-			// Try a new location
-			int x = node.p.x + aDirOffset[dir].x;
-			int y = node.p.y + aDirOffset[dir].y;
-
-			/*
-			   5  6  7
-			     \|/
-			   4 -I- 0
-			     /|\
-			   3  2  1
-			   odd:orthogonal-adjacent tiles even:non-orthogonal-adjacent tiles
-			*/
-			if (dir % 2 != 0 && !context.dstIgnore.isNonblocking(node.p.x, node.p.y) && !context.dstIgnore.isNonblocking(x, y))
-			{
-				int x2, y2;
-
-				// We cannot cut corners
-				x2 = node.p.x + aDirOffset[(dir + 1) % 8].x;
-				y2 = node.p.y + aDirOffset[(dir + 1) % 8].y;
-				if (context.isBlocked(x2, y2))
-				{
-					continue;
-				}
-				x2 = node.p.x + aDirOffset[(dir + 7) % 8].x;
-				y2 = node.p.y + aDirOffset[(dir + 7) % 8].y;
-				if (context.isBlocked(x2, y2))
-				{
-					continue;
-				}
-			}
-
-			// See if the node is a blocking tile
-			if (context.isBlocked(x, y))
-			{
-				// tile is blocked, skip it
-				continue;
-			}
-
-			// Now insert the point into the appropriate list, if not already visited.
-			fpathNewNode(context, tileF, PathCoord(x, y), node.dist, node.p);
-		}
+		fpathAStarExpand(context, tileF, node);
 	}
 
 	return nearestCoord;
@@ -441,10 +454,122 @@ static void fpathInitContext(PathfindContext &context, std::shared_ptr<PathBlock
 	ASSERT(!context.nodes.empty(), "fpathNewNode failed to add node.");
 }
 
+/// Explores every tile that can reach the context's start tile, so the context knows the way from all of them.
+static void fpathAStarExploreAll(PathfindContext &context)
+{
+	while (!context.nodes.empty())
+	{
+		PathNode node = fpathTakeNode(context.nodes);
+		if (context.map[node.p.x + node.p.y * mapWidth].visited)
+		{
+			continue;  // Already been here.
+		}
+		context.map[node.p.x + node.p.y * mapWidth].visited = true;
+
+		fpathAStarExpand(context, context.tileS, node);
+	}
+}
+
+/// Finds or builds the flow field for the job's destination and blocking map.
+static PathfindContext &fpathGetFlowField(PATHJOB *psJob, PathCoord tileDest, PathNonblockingArea dstIgnore)
+{
+	// Fields for blocking maps of earlier ticks can never be used again.
+	const uint32_t time = psJob->blockingMap->type.gameTime;
+	fpathFlowFields.remove_if([time](PathfindContext const &field) { return field.myGameTime != time; });
+
+	auto fieldIterator = std::find_if(fpathFlowFields.begin(), fpathFlowFields.end(), [&](PathfindContext const &field) {
+		return field.matches(psJob->blockingMap, tileDest, dstIgnore);
+	});
+	if (fieldIterator == fpathFlowFields.end())
+	{
+		if (fpathFlowFields.size() >= FLOWFIELD_MAX)
+		{
+			fpathFlowFields.pop_back();
+		}
+		fpathFlowFields.emplace_front();
+		PathfindContext &field = fpathFlowFields.front();
+		// Search from the destination, like an A* context reused for a second droid going there.
+		fpathInitContext(field, psJob->blockingMap, tileDest, tileDest, tileDest, dstIgnore);
+		fpathAStarExploreAll(field);
+	}
+	else if (fieldIterator != fpathFlowFields.begin())
+	{
+		fpathFlowFields.splice(fpathFlowFields.begin(), fpathFlowFields, fieldIterator);
+	}
+	return fpathFlowFields.front();
+}
+
+/// Follows a context's way back to its start tile from endCoord, with the same sub-tile smoothing for every route.
+/// Returns false if the way back is broken.
+static bool fpathAStarTracePath(PathfindContext const &context, PathCoord endCoord, std::vector<Vector2i> &path)
+{
+	path.clear();
+
+	Vector2i newP(0, 0);
+	for (Vector2i p(world_coord(endCoord.x) + TILE_UNITS / 2, world_coord(endCoord.y) + TILE_UNITS / 2); true; p = newP)
+	{
+		ASSERT_OR_RETURN(false, worldOnMap(p.x, p.y), "Assigned XY coordinates (%d, %d) not on map!", (int)p.x, (int)p.y);
+		ASSERT_OR_RETURN(false, path.size() < (static_cast<size_t>(mapWidth) * static_cast<size_t>(mapHeight)), "Pathfinding got in a loop.");
+
+		path.push_back(p);
+
+		PathExploredTile const &tile = context.map[map_coord(p.x) + map_coord(p.y) * mapWidth];
+		newP = p - Vector2i(tile.dx, tile.dy) * (TILE_UNITS / 64);
+		Vector2i mapP = map_coord(newP);
+		int xSide = newP.x - world_coord(mapP.x) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on right-hand side of the tile, or -1 if newP is on the left-hand side of the tile.
+		int ySide = newP.y - world_coord(mapP.y) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on bottom side of the tile, or -1 if newP is on the top side of the tile.
+		if (context.isBlocked(mapP.x + xSide, mapP.y))
+		{
+			newP.x = world_coord(mapP.x) + TILE_UNITS / 2; // Point too close to a blocking tile on left or right side, so move the point to the middle.
+		}
+		if (context.isBlocked(mapP.x, mapP.y + ySide))
+		{
+			newP.y = world_coord(mapP.y) + TILE_UNITS / 2; // Point too close to a blocking tile on rop or bottom side, so move the point to the middle.
+		}
+		if (map_coord(p) == Vector2i(context.tileS.x, context.tileS.y) || p == newP)
+		{
+			break;  // We stopped moving, because we reached the destination or the closest reachable tile to context.tileS. Give up now.
+		}
+	}
+	return true;
+}
+
+/// Follows the flow field to the destination. Returns false if the destination can't be reached from the origin,
+/// leaving it to A* to find the nearest reachable tile.
+static bool fpathFlowFieldRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
+{
+	const PathCoord tileOrig(map_coord(psJob->origX), map_coord(psJob->origY));
+	const PathCoord tileDest(map_coord(psJob->destX), map_coord(psJob->destY));
+	PathfindContext &field = fpathGetFlowField(psJob, tileDest, PathNonblockingArea(psJob->dstStructure));
+
+	const PathExploredTile &origTile = field.map[tileOrig.x + tileOrig.y * mapWidth];
+	if (origTile.iteration != field.iteration || !origTile.visited)
+	{
+		return false;
+	}
+
+	static std::vector<Vector2i> path;  // Declared static to save allocations.
+	if (!fpathAStarTracePath(field, tileOrig, path))
+	{
+		return false;
+	}
+
+	// Reached the destination, so use its exact coordinates for the last point.
+	path.back() = Vector2i(psJob->destX, psJob->destY);
+	psMove->asPath = path;
+	psMove->destination = psMove->asPath.back();
+	return true;
+}
+
 ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
 {
 	ASR_RETVAL      retval = ASR_OK;
 
+	if (psJob->flowField && fpathFlowFieldRoute(psMove, psJob))
+	{
+		return ASR_OK;
+	}
+
 	bool            mustReverse = true;
 
 	const PathCoord tileOrig(map_coord(psJob->origX), map_coord(psJob->origY));
@@ -514,33 +639,9 @@ ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
 
 	// Get route, in reverse order.
 	static std::vector<Vector2i> path;  // Declared static to save allocations.
-	path.clear();
-
-	Vector2i newP(0, 0);
-	for (Vector2i p(world_coord(endCoord.x) + TILE_UNITS / 2, world_coord(endCoord.y) + TILE_UNITS / 2); true; p = newP)
+	if (!fpathAStarTracePath(context, endCoord, path))
 	{
-		ASSERT_OR_RETURN(ASR_FAILED, worldOnMap(p.x, p.y), "Assigned XY coordinates (%d, %d) not on map!", (int)p.x, (int)p.y);
-		ASSERT_OR_RETURN(ASR_FAILED, path.size() < (static_cast<size_t>(mapWidth) * static_cast<size_t>(mapHeight)), "Pathfinding got in a loop.");
-
-		path.push_back(p);
-
-		PathExploredTile &tile = context.map[map_coord(p.x) + map_coord(p.y) * mapWidth];
-		newP = p - Vector2i(tile.dx, tile.dy) * (TILE_UNITS / 64);
-		Vector2i mapP = map_coord(newP);
-		int xSide = newP.x - world_coord(mapP.x) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on right-hand side of the tile, or -1 if newP is on the left-hand side of the tile.
-		int ySide = newP.y - world_coord(mapP.y) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on bottom side of the tile, or -1 if newP is on the top side of the tile.
-		if (context.isBlocked(mapP.x + xSide, mapP.y))
-		{
-			newP.x = world_coord(mapP.x) + TILE_UNITS / 2; // Point too close to a blocking tile on left or right side, so move the point to the middle.
-		}
-		if (context.isBlocked(mapP.x, mapP.y + ySide))
-		{
-			newP.y = world_coord(mapP.y) + TILE_UNITS / 2; // Point too close to a blocking tile on rop or bottom side, so move the point to the middle.
-		}
-		if (map_coord(p) == Vector2i(context.tileS.x, context.tileS.y) || p == newP)
-		{
-			break;  // We stopped moving, because we reached the destination or the closest reachable tile to context.tileS. Give up now.
-		}
+		return ASR_FAILED;
 	}
 	if (retval == ASR_OK)
 	{
@@ -0,0 +1,250 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2024  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "benchmark.h"
+
+#include "lib/framework/frame.h"
+#include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
+
+#include "clparse.h"
+#include "multiplay.h"
+#include "version.h"
+
+#include <algorithm>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Used unless --benchmark-seed is given, so that every run of a scenario simulates the same game.
+#define BENCHMARK_DEFAULT_SEED 0x2100u
+
+enum class BenchmarkMode
+{
+	Disabled,
+	Skirmish,
+	Replay
+};
+
+static BenchmarkMode benchmarkMode = BenchmarkMode::Disabled;
+static uint32_t benchmarkGameMinutes = 0;
+static uint32_t benchmarkRandomSeed = BENCHMARK_DEFAULT_SEED;
+static std::string benchmarkReplayName;
+static bool benchmarkReported = false;
+static optional<std::chrono::steady_clock::time_point> benchmarkStartTime;
+static std::vector<uint64_t> tickSamples;
+
+static const char *subsystemNames[] = {"script", "visibility", "pathing", "droids", "structures", "projectiles"};
+static_assert(sizeof(subsystemNames) / sizeof(subsystemNames[0]) == static_cast<size_t>(BenchmarkSubsystem::Count), "Missing subsystem names");
+
+struct SubsystemStats
+{
+	uint64_t currentTickUs = 0;
+	uint64_t totalUs = 0;
+	uint64_t maxTickUs = 0;
+};
+static SubsystemStats subsystemStats[static_cast<size_t>(BenchmarkSubsystem::Count)];
+static uint64_t otherTotalUs = 0;
+static uint64_t otherMaxTickUs = 0;
+
+void benchmarkSetGameMinutes(uint32_t minutes)
+{
+	benchmarkGameMinutes = minutes;
+	benchmarkMode = (minutes != 0) ? BenchmarkMode::Skirmish : BenchmarkMode::Disabled;
+}
+
+void benchmarkSetReplay(const std::string &replayName)
+{
+	benchmarkReplayName = replayName;
+	benchmarkGameMinutes = 0;
+	benchmarkMode = BenchmarkMode::Replay;
+}
+
+void benchmarkSetSeed(uint32_t seed)
+{
+	benchmarkRandomSeed = seed;
+}
+
+bool benchmarkEnabled()
+{
+	return benchmarkMode != BenchmarkMode::Disabled;
+}
+
+uint32_t benchmarkSeed()
+{
+	return benchmarkRandomSeed;
+}
+
+BenchmarkScope::~BenchmarkScope()
+{
+	if (active)
+	{
+		auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		subsystemStats[static_cast<size_t>(subsystem)].currentTickUs += static_cast<uint64_t>(durationUs);
+	}
+}
+
+/// Nearest-rank percentile. Partially sorts samples.
+static uint64_t samplePercentile(std::vector<uint64_t> &samples, unsigned percentile)
+{
+	if (samples.empty())
+	{
+		return 0;
+	}
+	size_t rank = (samples.size() * percentile + 99) / 100;
+	size_t idx = std::min(std::max<size_t>(rank, 1), samples.size()) - 1;
+	std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+	return samples[idx];
+}
+
+static nlohmann::ordered_json subsystemReport(uint64_t totalUs, uint64_t maxTickUs, size_t ticks)
+{
+	nlohmann::ordered_json j = nlohmann::ordered_json::object();
+	j["totalUs"] = totalUs;
+	j["meanUs"] = (ticks > 0) ? totalUs / ticks : 0;
+	j["maxUs"] = maxTickUs;
+	return j;
+}
+
+static void benchmarkReport(const char *reason)
+{
+	const size_t ticks = tickSamples.size();
+	const double wallSeconds = benchmarkStartTime.has_value() ? std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmarkStartTime.value()).count() : 0.0;
+
+	uint64_t tickTotalUs = 0;
+	for (uint64_t sample : tickSamples)
+	{
+		tickTotalUs += sample;
+	}
+
+	nlohmann::ordered_json tickUs = nlohmann::ordered_json::object();
+	tickUs["total"] = tickTotalUs;
+	tickUs["mean"] = (ticks > 0) ? tickTotalUs / ticks : 0;
+	tickUs["p50"] = samplePercentile(tickSamples, 50);
+	tickUs["p90"] = samplePercentile(tickSamples, 90);
+	tickUs["p99"] = samplePercentile(tickSamples, 99);
+	tickUs["max"] = tickSamples.empty() ? 0 : *std::max_element(tickSamples.begin(), tickSamples.end());
+
+	nlohmann::ordered_json subsystems = nlohmann::ordered_json::object();
+	for (size_t i = 0; i < static_cast<size_t>(BenchmarkSubsystem::Count); ++i)
+	{
+		subsystems[subsystemNames[i]] = subsystemReport(subsystemStats[i].totalUs, subsystemStats[i].maxTickUs, ticks);
+	}
+	subsystems["other"] = subsystemReport(otherTotalUs, otherMaxTickUs, ticks);
+
+	nlohmann::ordered_json report = nlohmann::ordered_json::object();
+	report["version"] = version_getVersionString();
+	if (benchmarkMode == BenchmarkMode::Replay)
+	{
+		report["replay"] = benchmarkReplayName;
+	}
+	else
+	{
+		report["scenario"] = wz_skirmish_test();
+		report["seed"] = benchmarkRandomSeed;
+		report["gameMinutes"] = benchmarkGameMinutes;
+	}
+	report["map"] = game.map;
+	report["result"] = reason;
+	report["gameTime"] = gameTime;
+	report["ticks"] = ticks;
+	report["wallSeconds"] = wallSeconds;
+	report["ticksPerSecond"] = (wallSeconds > 0) ? ticks / wallSeconds : 0.0;
+	report["tickUs"] = std::move(tickUs);
+	report["subsystemsUs"] = std::move(subsystems);
+
+	const GameTimeCrcStats crcStats = gtimeGetCrcStats();
+	nlohmann::ordered_json crc = nlohmann::ordered_json::object();
+	crc["checked"] = crcStats.checked;
+	crc["mismatched"] = crcStats.mismatched;
+	if (crcStats.mismatched > 0)
+	{
+		crc["firstMismatchGameTime"] = crcStats.firstMismatchGameTime;
+	}
+	report["crc"] = std::move(crc);
+
+	std::string output = report.dump(1, '\t', false, nlohmann::ordered_json::error_handler_t::replace) + "\n";
+	fputs(output.c_str(), stdout);
+	fflush(stdout);
+}
+
+static void benchmarkFinish(const char *reason);
+
+void benchmarkRecordGameTick(uint64_t durationMicroseconds)
+{
+	if (!benchmarkEnabled() || benchmarkReported)
+	{
+		return;
+	}
+	if (!benchmarkStartTime.has_value())
+	{
+		// Exclude loading the level from the measured wall time.
+		benchmarkStartTime = std::chrono::steady_clock::now() - std::chrono::microseconds(durationMicroseconds);
+	}
+	tickSamples.push_back(durationMicroseconds);
+
+	uint64_t subsystemsUs = 0;
+	for (auto &stats : subsystemStats)
+	{
+		stats.totalUs += stats.currentTickUs;
+		stats.maxTickUs = std::max(stats.maxTickUs, stats.currentTickUs);
+		subsystemsUs += stats.currentTickUs;
+		stats.currentTickUs = 0;
+	}
+	uint64_t otherUs = (durationMicroseconds > subsystemsUs) ? durationMicroseconds - subsystemsUs : 0;
+	otherTotalUs += otherUs;
+	otherMaxTickUs = std::max(otherMaxTickUs, otherUs);
+
+	if (benchmarkMode == BenchmarkMode::Skirmish && gameTime >= benchmarkGameMinutes * GAME_TICKS_PER_SEC * 60)
+	{
+		benchmarkFinish("timeLimit");
+	}
+}
+
+static void benchmarkFinish(const char *reason)
+{
+	if (!benchmarkEnabled() || benchmarkReported)
+	{
+		return;
+	}
+	benchmarkReported = true;
+	debug(LOG_INFO, "Benchmark finished (%s) at gameTime %" PRIu32, reason, gameTime);
+	benchmarkReport(reason);
+	const bool desynced = gtimeGetCrcStats().mismatched > 0;
+	if (desynced)
+	{
+		debug(LOG_ERROR, "Benchmark found sync CRC mismatches");
+	}
+	wzQuit(desynced ? 1 : 0); // Trigger a *graceful* shutdown
+}
+
+void benchmarkGameOver()
+{
+	if (benchmarkMode == BenchmarkMode::Skirmish)
+	{
+		benchmarkFinish("gameOver");
+	}
+}
+
+void benchmarkReplayEnded()
+{
+	if (benchmarkMode == BenchmarkMode::Replay)
+	{
+		benchmarkFinish("replayEnded");
+	}
+}
@@ -0,0 +1,79 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2024  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+
+/// Simulation benchmark modes, which run headless without real-time pacing, then print a JSON report to stdout and quit:
+/// - --benchmark: runs a --skirmish test for a fixed number of game minutes, with a fixed random seed.
+/// - --replay-benchmark: re-simulates a --loadreplay replay to its end, checking the recorded sync CRCs.
+///   Quits with exit code 1 if any CRC did not match.
+
+enum class BenchmarkSubsystem
+{
+	Script,
+	Visibility,
+	Pathing,
+	Droids,
+	Structures,
+	Projectiles,
+	Count
+};
+
+/// Enables skirmish benchmark mode. 0 disables it.
+void benchmarkSetGameMinutes(uint32_t minutes);
+void benchmarkSetSeed(uint32_t seed);
+/// Enables replay benchmark mode.
+void benchmarkSetReplay(const std::string &replayName);
+bool benchmarkEnabled();
+/// The synchronised random seed to use for the game.
+uint32_t benchmarkSeed();
+
+/// Records the wall-clock duration of a single game state update (gameStateUpdate).
+/// Prints the report and quits once the requested game time has been simulated.
+void benchmarkRecordGameTick(uint64_t durationMicroseconds);
+
+/// Called when the game is over. Ends a skirmish benchmark early; replays are simulated until they end.
+void benchmarkGameOver();
+/// Called when the REPLAY_ENDED message is processed.
+void benchmarkReplayEnded();
+
+/// Accumulates the time spent in a subsystem during the current game state update.
+class BenchmarkScope
+{
+public:
+	explicit BenchmarkScope(BenchmarkSubsystem subsystem)
+		: subsystem(subsystem)
+		, active(benchmarkEnabled())
+	{
+		if (active)
+		{
+			start = std::chrono::steady_clock::now();
+		}
+	}
+	~BenchmarkScope();
+
+private:
+	BenchmarkSubsystem subsystem;
+	bool active;
+	std::chrono::steady_clock::time_point start;
+};
@@ -47,19 +47,91 @@
 // someone needs to take a good look at the radius calculation
 #define SCALE_DEPTH (FP12_MULTIPLIER*7)
 
+// Bits of the sort key holding the index into bucketArray, and holding the object type
+#define BUCKET_INDEX_BITS	24
+#define BUCKET_INDEX_MASK	((UINT64_C(1) << BUCKET_INDEX_BITS) - 1)
+#define BUCKET_TYPE_MASK	UINT64_C(0xFF)
+// Below this many objects, std::sort beats the radix sort
+#define BUCKET_RADIX_MIN_SIZE	64
+
 struct BUCKET_TAG
 {
-	bool operator <(BUCKET_TAG const &b) const
-	{
-		return actualZ > b.actualZ;    // Sort in reverse z order.
-	}
-
 	RENDER_TYPE     objectType; //type of object held
 	void           *pObject;    //pointer to the object
-	int32_t         actualZ;
 };
 
 static std::vector<BUCKET_TAG> bucketArray;
+static std::vector<uint64_t> bucketKeys;	///< One sort key per bucketArray entry, see bucketSortKey()
+static std::vector<uint64_t> bucketSortScratch;
+
+/**
+ * Packs depth, type and insertion order, so that sorting the keys in ascending order gives the drawing order.
+ * The depth is reversed, to draw back to front. Objects at the same depth (such as all models sharing a texture page)
+ * then form runs of the same type, in the order they were added.
+ */
+static inline uint64_t bucketSortKey(int32_t actualZ, RENDER_TYPE objectType, size_t index)
+{
+	const uint32_t reversedZ = ~(static_cast<uint32_t>(actualZ) ^ 0x80000000u);
+	return (static_cast<uint64_t>(reversedZ) << 32) | (static_cast<uint64_t>(objectType) << BUCKET_INDEX_BITS) | index;
+}
+
+static inline RENDER_TYPE bucketKeyType(uint64_t key)
+{
+	return static_cast<RENDER_TYPE>((key >> BUCKET_INDEX_BITS) & BUCKET_TYPE_MASK);
+}
+
+/// LSD radix sort of the keys, a byte at a time. Bytes which are the same in every key (usually most of the index and type) are skipped.
+static void bucketSortKeys()
+{
+	const size_t count = bucketKeys.size();
+	if (count < BUCKET_RADIX_MIN_SIZE)
+	{
+		std::sort(bucketKeys.begin(), bucketKeys.end());
+		return;
+	}
+
+	bucketSortScratch.resize(count);
+	uint64_t *src = bucketKeys.data();
+	uint64_t *dst = bucketSortScratch.data();
+	for (unsigned shift = 0; shift < 64; shift += 8)
+	{
+		size_t offsets[256] = {0};
+		for (size_t i = 0; i < count; ++i)
+		{
+			++offsets[(src[i] >> shift) & 0xFF];
+		}
+		if (offsets[(src[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+		size_t offset = 0;
+		for (size_t &bucket : offsets)
+		{
+			size_t bucketSize = bucket;
+			bucket = offset;
+			offset += bucketSize;
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			dst[offsets[(src[i] >> shift) & 0xFF]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+	if (src != bucketKeys.data())
+	{
+		std::copy(src, src + count, bucketKeys.data());
+	}
+}
+
+/// Render the sorted objects first ... last - 1, which are all of type T
+template <typename T, typename Render>
+static inline void bucketRenderRun(size_t first, size_t last, Render &&render)
+{
+	for (size_t i = first; i < last; ++i)
+	{
+		render(static_cast<T *>(bucketArray[bucketKeys[i] & BUCKET_INDEX_MASK].pObject));
+	}
+}
 
 static SDWORD bucketCalculateZ(RENDER_TYPE objectType, void *pObject, const glm::mat4 &perspectiveViewMatrix)
 {
@@ -377,9 +449,10 @@ void bucketAddTypeToList(RENDER_TYPE objectType, void *pObject, const glm::mat4
 	//put the object data into the tag
 	newTag.objectType = objectType;
 	newTag.pObject = pObject;
-	newTag.actualZ = z;
 
 	//add tag to bucketArray
+	ASSERT_OR_RETURN(, bucketArray.size() <= BUCKET_INDEX_MASK, "Too many objects to render");
+	bucketKeys.push_back(bucketSortKey(z, objectType, bucketArray.size()));
 	bucketArray.push_back(newTag);
 }
 
@@ -387,39 +460,44 @@ void bucketAddTypeToList(RENDER_TYPE objectType, void *pObject, const glm::mat4
 void bucketRenderCurrentList(const glm::mat4 &viewMatrix, const glm::mat4 &perspectiveViewMatrix)
 {
 	WZ_PROFILE_SCOPE(bucketRenderCurrentList);
-	std::sort(bucketArray.begin(), bucketArray.end());
+	bucketSortKeys();
 
-	for (auto thisTag = bucketArray.cbegin(); thisTag != bucketArray.cend(); ++thisTag)
+	// dispatch once per run of objects of the same type, rather than once per object
+	for (size_t first = 0, last = 0; first < bucketKeys.size(); first = last)
 	{
-		switch (thisTag->objectType)
+		const RENDER_TYPE objectType = bucketKeyType(bucketKeys[first]);
+		for (last = first + 1; last < bucketKeys.size() && bucketKeyType(bucketKeys[last]) == objectType; ++last) {}
+
+		switch (objectType)
 		{
 		case RENDER_PARTICLE:
-			renderParticle((ATPART *)thisTag->pObject, viewMatrix);
+			bucketRenderRun<ATPART>(first, last, [&](ATPART *psPart) { renderParticle(psPart, viewMatrix); });
 			break;
 		case RENDER_EFFECT:
-			renderEffect((EFFECT *)thisTag->pObject, viewMatrix);
+			bucketRenderRun<EFFECT>(first, last, [&](EFFECT *psEffect) { renderEffect(psEffect, viewMatrix); });
 			break;
 		case RENDER_DROID:
-			displayComponentObject((DROID *)thisTag->pObject, viewMatrix, perspectiveViewMatrix);
+			bucketRenderRun<DROID>(first, last, [&](DROID *psDroid) { displayComponentObject(psDroid, viewMatrix, perspectiveViewMatrix); });
 			break;
 		case RENDER_STRUCTURE:
-			renderStructure((STRUCTURE *)thisTag->pObject, viewMatrix, perspectiveViewMatrix);
+			bucketRenderRun<STRUCTURE>(first, last, [&](STRUCTURE *psStruct) { renderStructure(psStruct, viewMatrix, perspectiveViewMatrix); });
 			break;
 		case RENDER_FEATURE:
-			renderFeature((FEATURE *)thisTag->pObject, viewMatrix, perspectiveViewMatrix);
+			bucketRenderRun<FEATURE>(first, last, [&](FEATURE *psFeature) { renderFeature(psFeature, viewMatrix, perspectiveViewMatrix); });
 			break;
 		case RENDER_PROXMSG:
-			renderProximityMsg((PROXIMITY_DISPLAY *)thisTag->pObject, viewMatrix, perspectiveViewMatrix);
+			bucketRenderRun<PROXIMITY_DISPLAY>(first, last, [&](PROXIMITY_DISPLAY *psProxDisp) { renderProximityMsg(psProxDisp, viewMatrix, perspectiveViewMatrix); });
 			break;
 		case RENDER_PROJECTILE:
-			renderProjectile((PROJECTILE *)thisTag->pObject, viewMatrix, perspectiveViewMatrix);
+			bucketRenderRun<PROJECTILE>(first, last, [&](PROJECTILE *psProj) { renderProjectile(psProj, viewMatrix, perspectiveViewMatrix); });
 			break;
 		case RENDER_DELIVPOINT:
-			renderDeliveryPoint((FLAG_POSITION *)thisTag->pObject, false, viewMatrix, perspectiveViewMatrix);
+			bucketRenderRun<FLAG_POSITION>(first, last, [&](FLAG_POSITION *psPosition) { renderDeliveryPoint(psPosition, false, viewMatrix, perspectiveViewMatrix); });
 			break;
 		}
 	}
 
 	//reset the bucket array as we go
 	bucketArray.resize(0);
+	bucketKeys.resize(0);
 }
@@ -47,6 +47,8 @@
 #include "gamehistorylogger.h"
 #include "stdinreader.h"
 #include "seqdisp.h"
+#include "profiling.h"
+#include "benchmark.h"
 
 #include <cwchar>
 
@@ -89,6 +91,7 @@ static std::string wz_test;
 static std::string wz_autoratingUrl;
 static bool wz_autoratingEnable = false;
 static bool wz_cli_headless = false;
+static bool wz_replay_benchmark = false;
 static bool wz_streamer_spectator_mode = false;
 static bool wz_lobby_slashcommands = false;
 static int wz_min_autostart_players = -1;
@@ -364,9 +367,15 @@ typedef enum
 	CLI_ALLOW_VULKAN_IMPLICIT_LAYERS,
 	CLI_HOST_CHAT_CONFIG,
 	CLI_HOST_ASYNC_JOIN_APPROVAL,
+	CLI_BENCHMARK,
+	CLI_BENCHMARK_SEED,
+	CLI_REPLAY_BENCHMARK,
 #if defined(__EMSCRIPTEN__)
 	CLI_VIDEOURL,
 #endif
+#if defined(WZ_PROFILING_TRACE)
+	CLI_PROFILE_TRACE,
+#endif
 } CLI_OPTIONS;
 
 // Separate table that avoids *any* translated strings, to avoid any risk of gettext / libintl function calls
@@ -457,9 +466,15 @@ static const struct poptOption *getOptionsTable()
 		{ "allow-vulkan-implicit-layers", POPT_ARG_NONE, CLI_ALLOW_VULKAN_IMPLICIT_LAYERS, N_("Allow Vulkan implicit layers (that may be default-disabled due to potential crashes or bugs)"), nullptr },
 		{ "host-chat-config", POPT_ARG_STRING, CLI_HOST_CHAT_CONFIG, N_("Set the default hosting chat configuration / permissions"), "[allow,quickchat]" },
 		{ "async-join-approve", POPT_ARG_NONE, CLI_HOST_ASYNC_JOIN_APPROVAL, N_("Enable async join approval (for connecting clients)"), nullptr },
+		{ "benchmark", POPT_ARG_STRING, CLI_BENCHMARK, N_("Run the --skirmish test headless for the given game time as fast as possible, then print a JSON report"), N_("number of minutes") },
+		{ "benchmark-seed", POPT_ARG_STRING, CLI_BENCHMARK_SEED, N_("Random seed used by --benchmark"), N_("seed") },
+		{ "replay-benchmark", POPT_ARG_NONE, CLI_REPLAY_BENCHMARK, N_("Re-simulate the --loadreplay replay headless as fast as possible, checking sync, then print a JSON report"), nullptr },
 #if defined(__EMSCRIPTEN__)
 		{ "videourl", POPT_ARG_STRING, CLI_VIDEOURL,   N_("Base URL for on-demand video downloads"), N_("Base video URL") },
 #endif
+#if defined(WZ_PROFILING_TRACE)
+		{ "profile-trace", POPT_ARG_STRING, CLI_PROFILE_TRACE, N_("Write recent profiling events to a Chrome trace file on exit"), N_("file name") },
+#endif
 
 		// Terminating entry
 		{ nullptr, 0, 0,              nullptr,                                    nullptr },
@@ -1345,6 +1360,40 @@ bool ParseCommandLine(int argc, const char * const *argv)
 			NETsetAsyncJoinApprovalRequired(true);
 			break;
 
+		case CLI_BENCHMARK:
+		{
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr)
+			{
+				qFatal("Bad benchmark minutes count");
+			}
+			int token_intval = atoi(token);
+			if (token_intval <= 0 || token_intval > 24 * 60)
+			{
+				qFatal("Invalid benchmark minutes count");
+			}
+			benchmarkSetGameMinutes(static_cast<uint32_t>(token_intval));
+			wz_autogame = true;
+			wz_cli_headless = true;
+			setHeadlessGameMode(true);
+			break;
+		}
+
+		case CLI_BENCHMARK_SEED:
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr)
+			{
+				qFatal("Bad benchmark seed");
+			}
+			benchmarkSetSeed(static_cast<uint32_t>(strtoul(token, nullptr, 0)));
+			break;
+
+		case CLI_REPLAY_BENCHMARK:
+			wz_replay_benchmark = true;
+			wz_cli_headless = true;
+			setHeadlessGameMode(true);
+			break;
+
 #if defined(__EMSCRIPTEN__)
 		case CLI_VIDEOURL:
 			token = poptGetOptArg(poptCon);
@@ -1357,9 +1406,33 @@ bool ParseCommandLine(int argc, const char * const *argv)
 			break;
 #endif
 
+#if defined(WZ_PROFILING_TRACE)
+		case CLI_PROFILE_TRACE:
+			token = poptGetOptArg(poptCon);
+			if (token == nullptr || strlen(token) == 0)
+			{
+				qFatal("Missing profile trace file name");
+			}
+			profiling::traceSetDumpOnExit(token);
+			break;
+#endif
+
 		} // switch (option)
 	} // while
 
+	if (wz_replay_benchmark)
+	{
+		if (getHostLaunch() != HostLaunch::LoadReplay)
+		{
+			qFatal("--replay-benchmark requires --loadreplay");
+		}
+		benchmarkSetReplay(saveGameName);
+	}
+	else if (benchmarkEnabled() && getHostLaunch() != HostLaunch::Skirmish)
+	{
+		qFatal("--benchmark requires --skirmish");
+	}
+
 	return true;
 }
 
@@ -24,6 +24,8 @@
  *
  */
 
+#include <string>
+#include <unordered_map>
 #include <physfs.h>
 #include "lib/framework/physfs_ext.h"
 
@@ -102,10 +104,65 @@ void calcDataHash(const uint8_t *pBuffer, uint32_t size, uint32_t index)
 	return;
 }
 
+// Appends where a file was read from, its size and its modification time
+static void appendFileSignature(std::string &signature, const char *fileName)
+{
+	signature += fileName;
+	signature += '|';
+	signature += WZ_PHYSFS_getRealDir_String(fileName);
+	signature += '|';
+#if defined(WZ_PHYSFS_2_1_OR_GREATER)
+	PHYSFS_Stat metaData;
+	if (PHYSFS_stat(fileName, &metaData) != 0)
+	{
+		signature += std::to_string(metaData.filesize) + '|' + std::to_string(metaData.modtime);
+	}
+#else
+	signature += std::to_string(WZ_PHYSFS_getLastModTime(fileName));
+#endif
+	signature += '\n';
+}
+
+// Identifies the contents a WzConfig was read from: its file and any diffs/ merged into it
+static std::string dataSourceSignature(const WzConfig &ini)
+{
+	const std::string fileName = ini.fileName().toStdString();
+	std::string signature;
+	appendFileSignature(signature, fileName.c_str());
+	WZ_PHYSFS_enumerateFolders("diffs", [&](const char *i) -> bool {
+		std::string diffName = std::string("diffs/") + i + "/" + fileName;
+		if (PHYSFS_exists(diffName.c_str()))
+		{
+			appendFileSignature(signature, diffName.c_str());
+		}
+		return true; // continue
+	});
+	return signature;
+}
+
+// DataHash[index] after hashing a stats file, keyed by the index, the hash before it and the signature of the file.
+// Lets a host skip re-serialising and re-hashing identical data when games are set up back to back.
+static std::unordered_map<std::string, uint32_t> dataHashCache;
+
 static void calcDataHash(const WzConfig &ini, uint32_t index)
 {
+	if (!bMultiPlayer)
+	{
+		return;
+	}
+
+	std::string key = std::to_string(index) + '|' + std::to_string(DataHash[index]) + '|' + dataSourceSignature(ini);
+	auto it = dataHashCache.find(key);
+	if (it != dataHashCache.end())
+	{
+		DataHash[index] = it->second;
+		debug(LOG_NET, "DataHash[%2u] = %08x (unchanged %s)", index, DataHash[index], ini.fileName().toUtf8().c_str());
+		return;
+	}
+
 	std::string jsonDump = ini.compactStringRepresentation();
 	calcDataHash(reinterpret_cast<const uint8_t *>(jsonDump.data()), jsonDump.size(), index);
+	dataHashCache[key] = DataHash[index];
 }
 
 void resetDataHash()
@@ -486,11 +543,33 @@ static void dataSMSGRelease(void *pData)
 	delete pFilename;
 }
 
+static void dataImageRelease(void *pData);
+
+/*!
+ * Decode an image ahead of dataImageLoad, on a resource prefetch thread
+ */
+static void dataImagePrefetch(const char *fileName)
+{
+	iV_Image *psSprite = new iV_Image();
+	if (!iV_loadImage_PNG(fileName, psSprite))
+	{
+		delete psSprite; // dataImageLoad will try again and report it
+		return;
+	}
+	resStorePrefetched(fileName, psSprite, dataImageRelease);
+}
+
 /*!
  * Load an image from file
  */
 static bool dataImageLoad(const char *fileName, void **ppData)
 {
+	if (void *prefetched = resTakePrefetched(fileName))
+	{
+		*ppData = prefetched;
+		return true;
+	}
+
 	iV_Image *psSprite = new iV_Image();
 	if (!psSprite)
 	{
@@ -650,38 +729,39 @@ struct RES_TYPE_MIN_FILE
 	const char *aType;                      ///< points to the string defining the type (e.g. SCRIPT) - NULL indicates end of list
 	RES_FILELOAD fileLoad;                  ///< routine to process the data for this type
 	RES_FREE release;                       ///< routine to release the data (NULL indicates none)
+	RES_PREFETCH prefetch;                  ///< routine to read the file ahead of fileLoad on a worker thread (NULL indicates none)
 };
 
 static const RES_TYPE_MIN_FILE FileResourceTypes[] =
 {
-	{"SFEAT", bufferSFEATLoad, dataSFEATRelease},                  //feature stats file
-	{"STEMPL", bufferSTEMPLLoad, dataSTEMPLRelease},               //template and associated files
-	{"WAV", dataAudioLoad, (RES_FREE)sound_ReleaseTrack},
-	{"SWEAPON", bufferSWEAPONLoad, dataReleaseStats},
-	{"SBPIMD", bufferSBPIMDLoad, dataReleaseStats},
-	{"SBRAIN", bufferSBRAINLoad, dataReleaseStats},
-	{"SSENSOR", bufferSSENSORLoad, dataReleaseStats},
-	{"SECM", bufferSECMLoad, dataReleaseStats},
-	{"SREPAIR", bufferSREPAIRLoad, dataReleaseStats},
-	{"SCONSTR", bufferSCONSTRLoad, dataReleaseStats},
-	{"SPROP", bufferSPROPLoad, dataReleaseStats},
-	{"SPROPTYPES", bufferSPROPTYPESLoad, dataReleaseStats},
-	{"STERRTABLE", bufferSTERRTABLELoad, dataReleaseStats},
-	{"SBODY", bufferSBODYLoad, dataReleaseStats},
-	{"SWEAPMOD", bufferSWEAPMODLoad, dataReleaseStats},
-	{"SPROPSND", bufferSPROPSNDLoad, dataReleaseStats},
-	{"AUDIOCFG", dataAudioCfgLoad, nullptr},
-	{"IMGPAGE", dataImageLoad, dataImageRelease},
-	{"TERTILES", dataTERTILESLoad, nullptr},
-	{"IMG", dataIMGLoad, dataIMGRelease},
-	{"TEXPAGE", nullptr, nullptr}, // ignored
-	{"TCMASK", nullptr, nullptr}, // ignored
-	{"STR_RES", dataStrResLoad, dataStrResRelease},
-	{"RESEARCHMSG", dataResearchMsgLoad, dataSMSGRelease },
-	{"SSTRMOD", bufferSSTRMODLoad, nullptr},
-	{"JAVASCRIPT", jsLoad, nullptr},
-	{"SSTRUCT", bufferSSTRUCTLoad, dataSSTRUCTRelease},            //structure stats and associated files
-	{"RESCH", bufferRESCHLoad, dataRESCHRelease},                  //research stats files
+	{"SFEAT", bufferSFEATLoad, dataSFEATRelease, wzConfigPrefetch},  //feature stats file
+	{"STEMPL", bufferSTEMPLLoad, dataSTEMPLRelease, nullptr},      //template and associated files
+	{"WAV", dataAudioLoad, (RES_FREE)sound_ReleaseTrack, nullptr},
+	{"SWEAPON", bufferSWEAPONLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SBPIMD", bufferSBPIMDLoad, dataReleaseStats, nullptr},
+	{"SBRAIN", bufferSBRAINLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SSENSOR", bufferSSENSORLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SECM", bufferSECMLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SREPAIR", bufferSREPAIRLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SCONSTR", bufferSCONSTRLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SPROP", bufferSPROPLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SPROPTYPES", bufferSPROPTYPESLoad, dataReleaseStats, wzConfigPrefetch},
+	{"STERRTABLE", bufferSTERRTABLELoad, dataReleaseStats, wzConfigPrefetch},
+	{"SBODY", bufferSBODYLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SWEAPMOD", bufferSWEAPMODLoad, dataReleaseStats, wzConfigPrefetch},
+	{"SPROPSND", bufferSPROPSNDLoad, dataReleaseStats, nullptr},
+	{"AUDIOCFG", dataAudioCfgLoad, nullptr, wzConfigPrefetch},
+	{"IMGPAGE", dataImageLoad, dataImageRelease, dataImagePrefetch},
+	{"TERTILES", dataTERTILESLoad, nullptr, nullptr},
+	{"IMG", dataIMGLoad, dataIMGRelease, nullptr},
+	{"TEXPAGE", nullptr, nullptr, nullptr}, // ignored
+	{"TCMASK", nullptr, nullptr, nullptr}, // ignored
+	{"STR_RES", dataStrResLoad, dataStrResRelease, nullptr},
+	{"RESEARCHMSG", dataResearchMsgLoad, dataSMSGRelease, nullptr },
+	{"SSTRMOD", bufferSSTRMODLoad, nullptr, wzConfigPrefetch},
+	{"JAVASCRIPT", jsLoad, nullptr, nullptr},
+	{"SSTRUCT", bufferSSTRUCTLoad, dataSSTRUCTRelease, wzConfigPrefetch},  //structure stats and associated files
+	{"RESCH", bufferRESCHLoad, dataRESCHRelease, wzConfigPrefetch},  //research stats files
 };
 
 /* Pass all the data loading functions to the framework library */
@@ -715,7 +795,7 @@ bool dataInitLoadFuncs()
 
 		for (CurrentType = FileResourceTypes; CurrentType != EndType; ++CurrentType)
 		{
-			if (!resAddFileLoad(CurrentType->aType, CurrentType->fileLoad, CurrentType->release))
+			if (!resAddFileLoad(CurrentType->aType, CurrentType->fileLoad, CurrentType->release, CurrentType->prefetch))
 			{
 				return false; // error whilst adding a file load
 			}
@@ -31,6 +31,7 @@ Alex McLean, Pumpkin Studios, EIDOS Interactive, 1997
 #include "objects.h"
 #include "display.h"
 #include "hci.h"
+#include "radar.h"
 
 /*
 Definition of a tile to highlight - presently more than is required
@@ -99,6 +100,9 @@ void	adjustTileHeight(MAPTILE *psTile, SDWORD adjust)
 	if (newHeight >= TILE_MIN_HEIGHT && newHeight <= TILE_MAX_HEIGHT)
 	{
 		psTile->height = newHeight;
+
+		const int tileIndex = psTile - psMapTiles.get();
+		radarMarkTileDirty(tileIndex % mapWidth, tileIndex / mapWidth);
 	}
 }
 
@@ -51,6 +51,7 @@
 #include "mapgrid.h"
 #include "display3d.h"
 #include "random.h"
+#include "radar.h"
 
 /* The statistics for the features */
 std::vector<FEATURE_STATS> asFeatureStats;
@@ -340,6 +341,7 @@ FEATURE *buildFeature(FEATURE_STATS *psStats, UDWORD x, UDWORD y, bool FromSave,
 			if ((!psStats->tileDraw) && (FromSave == false))
 			{
 				psTile->height = height;
+				radarMarkTileDirty(b.map.x + width, b.map.y + breadth);
 			}
 		}
 	}
@@ -64,6 +64,20 @@ using packagedPathJob = wz::packaged_task<PATHRESULT()>;
 static std::list<packagedPathJob>    pathJobs;
 static std::unordered_map<uint32_t, wz::future<PATHRESULT>> pathResults;
 
+/// Number of droids that must be sent to the same place in the same tick before the rest of them share a flow field.
+#define FLOWFIELD_MIN_GROUP 8
+
+/// Path jobs queued this tick for one destination and blocking map.
+struct PathJobGroup
+{
+	std::shared_ptr<PathBlockingMap> blockingMap;
+	Vector2i        destTile;
+	StructureBounds dstStructure;
+	unsigned        count;
+};
+static std::vector<PathJobGroup> pathJobGroups;
+static uint32_t         pathJobGroupsTime = 0;
+
 static bool             waitingForResult = false;
 static uint32_t         waitingForResultId;
 static WZ_SEMAPHORE     *waitingForResultSemaphore = nullptr;
@@ -126,6 +140,7 @@ bool fpathInitialise()
 
 void fpathShutdown()
 {
+	pathJobGroups.clear();
 	if (fpathThread)
 	{
 		// Signal the path finding thread to quit
@@ -313,6 +328,29 @@ void fpathRemoveDroidData(int id)
 	pathResults.erase(id);
 }
 
+/// Counts the jobs queued this tick with the same destination and blocking map as this one, including this one.
+/// Runs on the main thread in game state order, so which jobs get a flow field is the same on all clients.
+static unsigned fpathCountGroupJob(PATHJOB const &job)
+{
+	if (pathJobGroupsTime != gameTime)
+	{
+		pathJobGroupsTime = gameTime;
+		pathJobGroups.clear();
+	}
+
+	const Vector2i destTile = map_coord(Vector2i(job.destX, job.destY));
+	for (PathJobGroup &group : pathJobGroups)
+	{
+		if (group.blockingMap == job.blockingMap && group.destTile == destTile
+		    && group.dstStructure.map == job.dstStructure.map && group.dstStructure.size == job.dstStructure.size)
+		{
+			return ++group.count;
+		}
+	}
+	pathJobGroups.push_back(PathJobGroup{job.blockingMap, destTile, job.dstStructure, 1});
+	return 1;
+}
+
 static FPATH_RETVAL fpathRoute(MOVE_CONTROL *psMove, unsigned id, int startX, int startY, int tX, int tY, PROPULSION_TYPE propulsionType,
                                DROID_TYPE droidType, FPATH_MOVETYPE moveType, int owner, bool acceptNearest, StructureBounds const &dstStructure)
 {
@@ -384,6 +422,7 @@ queuePathfinding:
 	job.acceptNearest = acceptNearest;
 	job.deleted = false;
 	fpathSetBlockingMap(&job);
+	job.flowField = fpathCountGroupJob(job) >= FLOWFIELD_MIN_GROUP;
 
 	debug(LOG_NEVER, "starting new job for droid %d 0x%x", id, id);
 	// Clear any results or jobs waiting already. It is a vital assumption that there is only one
@@ -503,12 +542,17 @@ PATHRESULT fpathExecute(PATHJOB job)
 }
 
 /** Find the length of the job queue. Function is thread-safe. */
-static size_t fpathJobQueueLength()
+size_t fpathJobQueueLength()
 {
 	size_t count = 0;
 
+	if (!fpathMutex)
+	{
+		return 0;
+	}
+
 	wzMutexLock(fpathMutex);
-	count = pathJobs.size();  // O(N) function call for std::list. .empty() is faster, but this function isn't used except in tests.
+	count = pathJobs.size();  // O(N) function call for std::list, but only called from tests and the (throttled) host telemetry.
 	wzMutexUnlock(fpathMutex);
 	return count;
 }
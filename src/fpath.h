@@ -57,6 +57,7 @@ struct PATHJOB
 	std::shared_ptr<PathBlockingMap> blockingMap;   ///< Map of blocking tiles.
 	bool		acceptNearest;
 	bool            deleted;        ///< Droid was deleted, so throw away result when complete. Must still process this PATHJOB, since processing order can affect resulting paths (but can't affect the path length).
+	bool            flowField;      ///< Part of a large group sent to the same place this tick, so route along a flow field shared by the group.
 };
 
 enum FPATH_RETVAL
@@ -114,6 +115,9 @@ static inline bool fpathBlockingTile(Vector2i tile, PROPULSION_TYPE propulsion)
  */
 void fpathSetDirectRoute(DROID *psDroid, SDWORD targetX, SDWORD targetY);
 
+/** Find the length of the job queue. Function is thread-safe. */
+size_t fpathJobQueueLength();
+
 /** Clean up path jobs and results for a droid. Function is thread-safe. */
 void fpathRemoveDroidData(int id);
 
@@ -2568,6 +2568,7 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 			apsExtractorLists[player].clear();
 		}
 		apsOilList[0].clear();
+		objmemListsChanged();
 		initFactoryNumFlag();
 	}
 
@@ -2982,6 +2983,7 @@ bool loadGame(const char *pGameToLoad, bool keepObjects, bool freeMem, bool User
 	if (gameType != GTYPE_SCENARIO_EXPAND)
 	{
 		psMapTiles = nullptr;
+		mapTilesReplaced();
 		// load in the map file
 		if (!data)
 		{
@@ -3389,6 +3391,7 @@ error:
 	freeAllFeatures();
 	droidTemplateShutDown();
 	psMapTiles = nullptr;
+	mapTilesReplaced();
 
 	/* Start the game clock */
 	gameTimeStart();
@@ -7491,6 +7494,7 @@ void loadFixupResearchPendingStates()
 				// For now: Just clear the STARTED_RESEARCH_PENDING bit, so that the user can re-start the research after loading the save
 				debug(LOG_INFO, "Resetting STARTED_RESEARCH_PENDING to 0 for: %s", asResearch[statInc].id.toUtf8().c_str());
 				pPlayerRes->ResearchStatus &= ~STARTED_RESEARCH_PENDING;
+				researchStatusChanged();
 			}
 		}
 	}
@@ -577,6 +577,11 @@ private:
 			{
 				case OutlineState::None:
 					break;
+				case OutlineState::Seek:
+					// uncapped: double outline in a warmer colour, so it is distinguishable from 3x
+					iV_Box(x0 + 3, y0 + 3, x1 - 3, y1 - 3, pal_RGBA(255, 200, 90, 220));
+					iV_Box(x0 + 1, y0 + 1, x1 - 1, y1 - 1, pal_RGBA(255, 200, 90, 220));
+					break;
 				case OutlineState::Double:
 					iV_Box(x0 + 3, y0 + 3, x1 - 3, y1 - 3, pal_RGBA(218, 207, 255, 200));
 					// fall-through
@@ -599,7 +604,8 @@ private:
 		enum class OutlineState {
 			None,
 			Single,
-			Double
+			Double,
+			Seek
 		};
 		OutlineState outline = OutlineState::None;
 	};
@@ -650,15 +656,20 @@ private:
 		size_t newFastForward = 0;
 		if (currFastForward == 0)
 		{
-			newFastForward = (!reverseDirection) ? 1 : WZ_MAX_REPLAY_FASTFORWARD_TICKS;
+			newFastForward = (!reverseDirection) ? 1 : WZ_UNCAPPED_FASTFORWARD_TICKS;
 		}
 		else if (currFastForward == 1)
 		{
 			newFastForward = (!reverseDirection) ? WZ_MAX_REPLAY_FASTFORWARD_TICKS : 0;
 		}
-		else if (reverseDirection && currFastForward == WZ_MAX_REPLAY_FASTFORWARD_TICKS)
+		else if (currFastForward == WZ_MAX_REPLAY_FASTFORWARD_TICKS)
+		{
+			// seek: as fast as possible, rendering only occasionally
+			newFastForward = (!reverseDirection) ? WZ_UNCAPPED_FASTFORWARD_TICKS : 1;
+		}
+		else if (currFastForward == WZ_UNCAPPED_FASTFORWARD_TICKS)
 		{
-			newFastForward = 1;
+			newFastForward = (!reverseDirection) ? 0 : WZ_MAX_REPLAY_FASTFORWARD_TICKS;
 		}
 		setMaxFastForwardTicks(newFastForward, true);
 
@@ -689,7 +700,12 @@ private:
 
 		// fast-forward state is based on getMaxFastForwardTicks
 		auto maxFastForwardTicks = getMaxFastForwardTicks();
-		if (maxFastForwardTicks > 0)
+		if (maxFastForwardTicks == WZ_UNCAPPED_FASTFORWARD_TICKS)
+		{
+			// seeking
+			fastForwardButton->outline = W_REPLAY_CONTROL_BUTTON::OutlineState::Seek;
+		}
+		else if (maxFastForwardTicks > 0)
 		{
 			// fast-forward is enabled
 			fastForwardButton->outline = (maxFastForwardTicks >= WZ_MAX_REPLAY_FASTFORWARD_TICKS) ? W_REPLAY_CONTROL_BUTTON::OutlineState::Double : W_REPLAY_CONTROL_BUTTON::OutlineState::Single;
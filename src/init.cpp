@@ -102,6 +102,8 @@
 #include "hci/teamstrategy.h"
 #include "screens/guidescreen.h"
 #include "wzapi.h"
+#include "benchmark.h"
+#include "telemetry.h"
 
 #include <algorithm>
 #include <unordered_map>
@@ -1271,11 +1273,12 @@ bool systemInitialise(unsigned int horizScalePercentage, unsigned int vertScaleP
 		return false;
 	}
 
-	if (!audio_Init(droidAudioTrackStopped, war_GetHRTFMode(), war_getSoundEnabled()))
+	const bool soundEnabled = war_getSoundEnabled() && !benchmarkEnabled(); // benchmarks never need audio
+	if (!audio_Init(droidAudioTrackStopped, war_GetHRTFMode(), soundEnabled))
 	{
 		debug(LOG_SOUND, "Continuing without audio");
 	}
-	if (war_getSoundEnabled() && war_GetMusicEnabled())
+	if (soundEnabled && war_GetMusicEnabled())
 	{
 		cdAudio_Open(UserMusicPath);
 	}
@@ -1569,6 +1572,7 @@ bool stageOneInitialise()
 	scriptInit();
 
 	gameTimeInit();
+	resetGameLoopCatchUp();
 	transitionInit();
 	resetScroll();
 
@@ -1953,6 +1957,9 @@ bool stageThreeInitialise()
 
 	countUpdate();
 
+	// don't report game ticks of the previous game, or of loading this one
+	telemetryReset();
+
 	if (getLevelLoadType() == GTYPE_SAVE_MIDMISSION || getLevelLoadType() == GTYPE_SAVE_START)
 	{
 		executeFnAndProcessScriptQueuedRemovals([]() { triggerEvent(TRIGGER_GAME_LOADED); });
@@ -2048,6 +2055,8 @@ bool stageThreeShutDown()
 
 	shutdown3DView();
 
+	telemetryReset();
+
 	return true;
 }
 
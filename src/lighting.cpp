@@ -41,6 +41,7 @@
 #include "display3d.h"
 #include "terrain.h"
 #include "warzoneconfig.h"
+#include "radar.h"
 
 // These magic values determine the fog
 #define FOG_ALTITUDE_COEFFICIENT 1.3f
@@ -115,6 +116,7 @@ void initLighting(UDWORD x1, UDWORD y1, UDWORD x2, UDWORD y2)
 			}
 		}
 	}
+	radarMarkAllDirty();
 }
 
 // For display purposes only (*NOT* for use in game state calculations)
@@ -88,6 +88,8 @@
 #include "gamehistorylogger.h"
 #include "profiling.h"
 #include "wzapi.h"
+#include "telemetry.h"
+#include "benchmark.h"
 
 #include "warzoneconfig.h"
 
@@ -96,6 +98,7 @@
 #endif
 
 #include <numeric>
+#include <chrono>
 
 
 /*
@@ -123,6 +126,15 @@ struct PAUSE_STATE
 static PAUSE_STATE pauseState;
 static size_t maxFastForwardTicks = WZ_DEFAULT_MAX_FASTFORWARD_TICKS;
 static bool fastForwardTicksFixedToNormalTickRate = true; // can be set to false to "catch-up" as quickly as possible (but this may result in more jerky behavior)
+// In benchmark mode, ticks are not paced by real time, but still return to the main loop every so often.
+static const size_t benchmarkMaxTicksPerLoop = 50;
+// Spectators this many game time updates behind the players stop waiting on rendering, and catch up as fast as possible...
+static const size_t catchUpMinUpdatesBehind = 50;
+// ...until they are back to normal fast-forward distance.
+static const size_t catchUpEndUpdatesBehind = 4;
+// While fast-forwarding uncapped, still render (and process input) at least this often (in ms of real time).
+static const unsigned uncappedFastForwardMaxUpdateTime = 250;
+static bool catchingUp = false;
 
 static unsigned numDroids[MAX_PLAYERS];
 static unsigned numMissionDroids[MAX_PLAYERS];
@@ -519,26 +531,34 @@ static void gameStateUpdate()
 
 	if (!paused && !scriptPaused())
 	{
+		BenchmarkScope benchmarkScope(BenchmarkSubsystem::Script);
 		executeFnAndProcessScriptQueuedRemovals([]() { updateScripts(); });
 	}
 
 	// Update abandoned structures
 	handleAbandonedStructures();
 
-	// Update the visibility change stuff
-	visUpdateLevel();
+	{
+		BenchmarkScope benchmarkScope(BenchmarkSubsystem::Visibility);
+
+		// Update the visibility change stuff
+		visUpdateLevel();
 
-	// Put all droids/structures/features into the grid.
-	gridReset();
+		// Put all droids/structures/features into the grid.
+		gridReset();
 
-	// Check which objects are visible.
-	processVisibility();
+		// Check which objects are visible.
+		processVisibility();
+	}
 
 	// Update the map.
 	mapUpdate();
 
 	//update the findpath system
-	fpathUpdate();
+	{
+		BenchmarkScope benchmarkScope(BenchmarkSubsystem::Pathing);
+		fpathUpdate();
+	}
 
 	// update the command droids
 	cmdDroidUpdate();
@@ -548,40 +568,49 @@ static void gameStateUpdate()
 		//update the current power available for a player
 		updatePlayerPower(i);
 
-		executeFnAndProcessScriptQueuedRemovals([i]() {
-			mutating_list_iterate(apsDroidLists[i], [](DROID* d)
-			{
-				droidUpdate(d);
-				return IterationResult::CONTINUE_ITERATION;
+		{
+			BenchmarkScope benchmarkScope(BenchmarkSubsystem::Droids);
+			executeFnAndProcessScriptQueuedRemovals([i]() {
+				mutating_list_iterate(apsDroidLists[i], [](DROID* d)
+				{
+					droidUpdate(d);
+					return IterationResult::CONTINUE_ITERATION;
+				});
 			});
-		});
-		executeFnAndProcessScriptQueuedRemovals([i]() {
-			mutating_list_iterate(mission.apsDroidLists[i], [](DROID* d)
-			{
-				missionDroidUpdate(d);
-				return IterationResult::CONTINUE_ITERATION;
+			executeFnAndProcessScriptQueuedRemovals([i]() {
+				mutating_list_iterate(mission.apsDroidLists[i], [](DROID* d)
+				{
+					missionDroidUpdate(d);
+					return IterationResult::CONTINUE_ITERATION;
+				});
 			});
-		});
+		}
 		// FIXME: These for-loops are code duplication
-		executeFnAndProcessScriptQueuedRemovals([i]() {
-			mutating_list_iterate(apsStructLists[i], [](STRUCTURE* s)
-			{
-				structureUpdate(s, false);
-				return IterationResult::CONTINUE_ITERATION;
+		{
+			BenchmarkScope benchmarkScope(BenchmarkSubsystem::Structures);
+			executeFnAndProcessScriptQueuedRemovals([i]() {
+				mutating_list_iterate(apsStructLists[i], [](STRUCTURE* s)
+				{
+					structureUpdate(s, false);
+					return IterationResult::CONTINUE_ITERATION;
+				});
 			});
-		});
-		executeFnAndProcessScriptQueuedRemovals([i]() {
-			mutating_list_iterate(mission.apsStructLists[i], [](STRUCTURE* s)
-			{
-				structureUpdate(s, true); // update for mission
-				return IterationResult::CONTINUE_ITERATION;
+			executeFnAndProcessScriptQueuedRemovals([i]() {
+				mutating_list_iterate(mission.apsStructLists[i], [](STRUCTURE* s)
+				{
+					structureUpdate(s, true); // update for mission
+					return IterationResult::CONTINUE_ITERATION;
+				});
 			});
-		});
+		}
 	}
 
 	missionTimerUpdate();
 
-	executeFnAndProcessScriptQueuedRemovals([]() { proj_UpdateAll(); });
+	{
+		BenchmarkScope benchmarkScope(BenchmarkSubsystem::Projectiles);
+		executeFnAndProcessScriptQueuedRemovals([]() { proj_UpdateAll(); });
+	}
 
 	for (FEATURE *psCFeat : apsFeatureLists[0])
 	{
@@ -615,6 +644,11 @@ void setMaxFastForwardTicks(optional<size_t> value, bool fixedToNormalTickRate)
 	fastForwardTicksFixedToNormalTickRate = fixedToNormalTickRate;
 }
 
+void resetGameLoopCatchUp()
+{
+	catchingUp = false;
+}
+
 static int renderBudget = 0;  // Scaled time spent rendering minus scaled time spent updating.
 const Rational renderFraction(2, 5);  // Minimum fraction of time spent rendering.
 const Rational updateFraction = Rational(1) - renderFraction;
@@ -647,7 +681,25 @@ GAMECODE gameLoop()
 
 	size_t numRegularUpdatesTicks = 0;
 	size_t numFastForwardTicks = 0;
+	const unsigned updateStartTime = wzGetTicks();
 	gameTimeUpdateBegin();
+
+	// Late-joining spectators run the simulation uncapped until they reach the players.
+	if (!catchingUp)
+	{
+		catchingUp = bMultiPlayer && NetPlay.players[selectedPlayer].isSpectator && !NetPlay.isHost && !NETisReplay() && NETgameIsBehindPlayersByAtLeast(catchUpMinUpdatesBehind);
+		if (catchingUp)
+		{
+			debug(LOG_INFO, "Catching up from gameTime %" PRIu32, gameTime);
+		}
+	}
+	else if (!NETgameIsBehindPlayersByAtLeast(catchUpEndUpdatesBehind))
+	{
+		catchingUp = false;
+		debug(LOG_INFO, "Caught up at gameTime %" PRIu32, gameTime);
+	}
+	const bool uncappedFastForward = catchingUp || maxFastForwardTicks == WZ_UNCAPPED_FASTFORWARD_TICKS;
+
 	while (true)
 	{
 		// Receive NET_BLAH messages.
@@ -656,14 +708,20 @@ GAMECODE gameLoop()
 
 		bool selectedPlayerIsSpectator = bMultiPlayer && NetPlay.players[selectedPlayer].isSpectator;
 		bool multiplayerHostDisconnected = bMultiPlayer && !NetPlay.isHostAlive && NetPlay.bComms && !NetPlay.isHost; // do not fast-forward after the host has disconnected
+		bool withinFastForwardLimit = (uncappedFastForward) ? (wzGetTicks() - updateStartTime < uncappedFastForwardMaxUpdateTime) : (numFastForwardTicks < maxFastForwardTicks);
 		bool canFastForwardGameTime =
 			selectedPlayerIsSpectator 			// current player must be a spectator
 			&& !NetPlay.isHost					// AND NOT THE HOST (!)
 			&& !multiplayerHostDisconnected		// and the multiplayer host must not be disconnected ("host quit")
-			&& numFastForwardTicks < maxFastForwardTicks // and the number of forced updates this call of gameLoop must not exceed the max allowed
+			&& withinFastForwardLimit			// and the number of forced updates (or time spent on them) this call of gameLoop must not exceed the max allowed
 			&& checkPlayerGameTime(NET_ALL_PLAYERS);	// and there must be a new game tick available to process from all players
 
-		bool forceTryGameTickUpdate = canFastForwardGameTime && ((!fastForwardTicksFixedToNormalTickRate && numForcedUpdatesLastCall > 0) || numRegularUpdatesTicks > 0) && NETgameIsBehindPlayersByAtLeast(4);
+		bool forceTryGameTickUpdate = canFastForwardGameTime && (uncappedFastForward || (!fastForwardTicksFixedToNormalTickRate && numForcedUpdatesLastCall > 0) || numRegularUpdatesTicks > 0) && NETgameIsBehindPlayersByAtLeast(catchUpEndUpdatesBehind);
+		if (benchmarkEnabled())
+		{
+			// Simulate as fast as possible, ignoring the real time.
+			forceTryGameTickUpdate = (numFastForwardTicks + numRegularUpdatesTicks) < benchmarkMaxTicksPerLoop;
+		}
 
 		// Update gameTime and graphicsTime, and corresponding deltas. Note that gameTime and graphicsTime pause, if we aren't getting our GAME_GAME_TIME messages.
 		auto timeUpdateResult = gameTimeUpdate(renderBudget > 0 || previousUpdateWasRender, forceTryGameTickUpdate);
@@ -686,9 +744,13 @@ GAMECODE gameLoop()
 		ASSERT(!paused && !gameUpdatePaused(), "Nonsensical pause values.");
 
 		unsigned before = wzGetTicks();
+		auto tickStart = std::chrono::steady_clock::now();
 		syncDebug("Begin game state update, gameTime = %d", gameTime);
 		gameStateUpdate();
 		syncDebug("End game state update, gameTime = %d", gameTime);
+		auto tickDurationUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count();
+		telemetryRecordGameTick(tickDurationUs);
+		benchmarkRecordGameTick(tickDurationUs);
 		unsigned after = wzGetTicks();
 
 		renderBudget -= (after - before) * renderFraction.n;
@@ -724,12 +786,14 @@ GAMECODE gameLoop()
 #endif
 	previousUpdateWasRender = true;
 
-	if (headlessGameMode() && autogame_enabled())
+	if (headlessGameMode() && autogame_enabled() && !benchmarkEnabled())
 	{
 		// Output occasional stats to stdout
 		stdOutGameSummary();
 	}
 
+	telemetryUpdate();
+
 	return renderReturn;
 }
 
@@ -77,8 +77,12 @@ bool scrollPaused();
 bool consolePaused();
 
 constexpr size_t WZ_DEFAULT_MAX_FASTFORWARD_TICKS = 1;
+/// Fast-forward as many ticks as possible, only returning to render every so often (see gameLoop).
+constexpr size_t WZ_UNCAPPED_FASTFORWARD_TICKS = static_cast<size_t>(-1);
 size_t getMaxFastForwardTicks();
 void setMaxFastForwardTicks(optional<size_t> value = nullopt, bool fixedToNormalTickRate = true);
+/// Forget any spectator catch-up in progress (call when starting a new game).
+void resetGameLoopCatchUp();
 
 void setGameUpdatePause(bool state);
 void setAudioPause(bool state);
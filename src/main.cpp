@@ -110,6 +110,7 @@
 #include "stdinreader.h"
 #include "gamehistorylogger.h"
 #include "campaigninfo.h"
+#include "profiling.h"
 #if defined(ENABLE_DISCORD)
 #include "integrations/wzdiscordrpc.h"
 #endif
@@ -1059,8 +1060,8 @@ static void startGameLoop()
 		}
 		else
 		{
-			// when loading replays in headless / autogame mode, set to fast-forward
-			setMaxFastForwardTicks(10, false);
+			// when loading replays in headless / autogame mode, run as fast as possible
+			setMaxFastForwardTicks(WZ_UNCAPPED_FASTFORWARD_TICKS, false);
 		}
 	}
 }
@@ -1876,6 +1877,9 @@ void mainShutdown()
 	writeFavoriteStructsFile(FavoriteStructuresPath);
 #if defined(ENABLE_DISCORD)
 	discordRPCShutdown();
+#endif
+#if defined(WZ_PROFILING_TRACE)
+	profiling::traceShutdown();
 #endif
 	wzCmdInterfaceShutdown();
 	urlRequestShutdown();
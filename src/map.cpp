@@ -25,6 +25,8 @@
  */
 #include <time.h>
 #include <algorithm>
+#include <tuple>
+#include <thread>
 
 #include "lib/framework/frame.h"
 #include "lib/framework/endian_hack.h"
@@ -51,23 +53,47 @@
 #include "astar.h"
 #include "fpath.h"
 #include "levels.h"
+#include "radar.h"
 #include "lib/framework/wzapp.h"
 #include "lib/ivis_opengl/pielighting.h"
 
 #define GAME_TICKS_FOR_DANGER (GAME_TICKS_PER_SEC * 2)
+#define DANGER_MAX_THREADS 4
 
-static WZ_THREAD *dangerThread = nullptr;
-static WZ_SEMAPHORE *dangerSemaphore = nullptr;
-static WZ_SEMAPHORE *dangerDoneSemaphore = nullptr;
 struct floodtile
 {
 	uint8_t x;
 	uint8_t y;
 };
-static struct floodtile *floodbucket = nullptr;
-static int bucketcounter;
+
+/// A danger map thread. Each round, it flood fills the players with (player % numDangerWorkers) == index.
+struct DangerWorker
+{
+	WZ_THREAD *thread = nullptr;
+	WZ_SEMAPHORE *startSemaphore = nullptr;
+	std::vector<floodtile> floodbucket;
+	int index = 0;
+};
+static DangerWorker dangerWorkers[DANGER_MAX_THREADS];
+static int numDangerWorkers = 0;
+static WZ_SEMAPHORE *dangerDoneSemaphore = nullptr;
+static bool dangerWorkersQuit = false;
+static bool dangerRoundPending = false;  ///< Workers are busy with (or about to start) a round
+static int dangerRoundPlayers = 0;       ///< Players 0..dangerRoundPlayers-1 are processed in the current round
+/// Per-player working copies of psAuxMap, used by the danger map threads. Only touched by the main thread between rounds.
+static std::unique_ptr<uint8_t[]> psDangerMaps[MAX_PLAYERS];
 static UDWORD lastDangerUpdate = 0;
-static int lastDangerPlayer = -1;
+
+/// A pending fire expiry. fireExpiryQueue is a min-heap ordered by expiry, then tile row and column, so tiles expiring
+/// in the same update are extinguished in the same (row-major) order as a full map scan would.
+struct FireExpiry
+{
+	uint32_t endUpdate;  ///< gameTime / GAME_TICKS_PER_UPDATE, not wrapped to 16 bits like MAPTILE::fireEndTime
+	int32_t y;
+	int32_t x;
+};
+static std::vector<FireExpiry> fireExpiryQueue;
+static bool fireExpiryQueueValid = false;  ///< Cleared whenever psMapTiles is replaced, see mapTilesReplaced()
 
 //scroll min and max values
 SDWORD		scrollMinX, scrollMaxX, scrollMinY, scrollMaxY;
@@ -123,6 +149,7 @@ static int getTextureType(const char *textureType);
 static bool hasDecals(int i, int j);
 static void SetDecals(const char *filename, const char *decal_type);
 static void init_tileNames(MAP_TILESET type);
+static void dangerShutdown();
 
 /// The different ground types
 static std::vector<GROUND_TYPE> groundTypes;
@@ -1016,6 +1043,7 @@ bool mapLoadFromWzMapData(std::shared_ptr<WzMap::MapData> loadedMap)
 
 	/* Allocate the memory for the map */
 	psMapTiles = std::make_unique<MAPTILE[]>(static_cast<size_t>(width) * height);
+	mapTilesReplaced();
 	getCurrentLightmapData().reset(width, height);
 	ASSERT(psMapTiles != nullptr, "Out of memory");
 
@@ -1059,6 +1087,7 @@ bool mapLoadFromWzMapData(std::shared_ptr<WzMap::MapData> loadedMap)
 		psMapTiles[i].jammerBits = 0;
 		psMapTiles[i].tileExploredBits = 0;
 	}
+	radarMarkAllDirty();
 
 	if (preview)
 	{
@@ -1203,23 +1232,11 @@ bool mapShutdown()
 {
 	int x;
 
-	if (dangerThread)
-	{
-		wzSemaphoreWait(dangerDoneSemaphore);
-		lastDangerPlayer = -1;
-		wzSemaphorePost(dangerSemaphore);
-		wzThreadJoin(dangerThread);
-		wzSemaphoreDestroy(dangerSemaphore);
-		wzSemaphoreDestroy(dangerDoneSemaphore);
-		dangerThread = nullptr;
-		dangerSemaphore = nullptr;
-		dangerDoneSemaphore = nullptr;
-	}
+	dangerShutdown();
 
 	mapDecals = nullptr;
 	psBlockMap[AUX_MAP] = nullptr;
 	psBlockMap[AUX_ASTARMAP] = nullptr;
-	free(floodbucket);
 	psBlockMap[AUX_DANGERMAP] = nullptr;
 	for (x = 0; x < MAX_PLAYERS + AUX_MAX; x++)
 	{
@@ -1227,11 +1244,11 @@ bool mapShutdown()
 	}
 
 	map = nullptr;
-	floodbucket = nullptr;
 	groundTypes.clear();
 	mapDecals = nullptr;
 	psMapTiles = nullptr;
 	mapWidth = mapHeight = 0;
+	mapTilesReplaced();
 	numTile_names = 0;
 	Tile_names = nullptr;
 	if (tilesetDir)
@@ -1826,6 +1843,7 @@ bool readVisibilityData(const char *fileName)
 			psMapTiles[i].tileExploredBits |= val << (plane * 8);
 		}
 	}
+	radarMarkAllDirty();
 
 	// Close the file
 	PHYSFS_close(fileHandle);
@@ -1925,6 +1943,47 @@ void mapFloodFillContinents()
 	debug(LOG_MAP, "Found %d limited and %d hover continents", limitedContinents, hoverContinents);
 }
 
+static bool fireExpiresAfter(const FireExpiry &a, const FireExpiry &b)
+{
+	return std::tie(a.endUpdate, a.y, a.x) > std::tie(b.endUpdate, b.y, b.x);
+}
+
+static void queueTileFireExpiry(int32_t posX, int32_t posY, const MAPTILE *tile)
+{
+	const uint32_t currentUpdate = gameTime / GAME_TICKS_PER_UPDATE;
+	// Same wrap-around as the uint16_t comparison in mapUpdate(), so the tile goes out when fireEndTime comes round next
+	const uint16_t remaining = tile->fireEndTime - (uint16_t)currentUpdate;
+	fireExpiryQueue.push_back({currentUpdate + remaining, posY, posX});
+	std::push_heap(fireExpiryQueue.begin(), fireExpiryQueue.end(), fireExpiresAfter);
+}
+
+void mapTilesReplaced()
+{
+	fireExpiryQueue.clear();
+	fireExpiryQueueValid = false;
+}
+
+/// Rebuilds fireExpiryQueue from the burning tiles of the current map, if psMapTiles was replaced since it was built.
+static void syncFireExpiryQueue()
+{
+	if (fireExpiryQueueValid || psMapTiles == nullptr)
+	{
+		return;
+	}
+	fireExpiryQueueValid = true;
+	for (int posY = 0; posY < mapHeight; ++posY)
+	{
+		for (int posX = 0; posX < mapWidth; ++posX)
+		{
+			const MAPTILE *tile = mapTile(posX, posY);
+			if (TileIsBurning(tile))
+			{
+				queueTileFireExpiry(posX, posY, tile);
+			}
+		}
+	}
+}
+
 void tileSetFire(int32_t x, int32_t y, uint32_t duration)
 {
 	const int posX = map_coord(x);
@@ -1943,8 +2002,10 @@ void tileSetFire(int32_t x, int32_t y, uint32_t duration)
 	}
 
 	// Burn, tile, burn!
+	syncFireExpiryQueue();
 	tile->tileInfoBits |= BITS_ON_FIRE;
 	tile->fireEndTime = fireEndTime;
+	queueTileFireExpiry(posX, posY, tile);
 
 	syncDebug("Fire tile{%d, %d} dur%u end%d", posX, posY, duration, fireEndTime);
 }
@@ -1961,13 +2022,14 @@ bool fireOnLocation(unsigned int x, unsigned int y)
 }
 
 // This function runs in a separate thread!
-static int dangerFloodFill(int player)
+static void dangerFloodFill(int player, uint8_t *auxMap, floodtile *floodbucket)
 {
 	int i;
 	Vector2i pos = getPlayerStartPosition(player);
 	Vector2i npos(0, 0);
 	uint8_t aux, block;
 	int x, y;
+	int bucketcounter = 0;
 	bool start = true;	// hack to disregard the blocking status of any building exactly on the starting position
 
 	// Set our danger bits
@@ -1975,14 +2037,12 @@ static int dangerFloodFill(int player)
 	{
 		for (x = 0; x < mapWidth; x++)
 		{
-			auxSet(x, y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_DANGER);
-			auxClear(x, y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_TEMPORARY);
+			auxMap[x + y * mapWidth] = (auxMap[x + y * mapWidth] | AUXBITS_DANGER) & ~AUXBITS_TEMPORARY;
 		}
 	}
 
 	pos.x = map_coord(pos.x);
 	pos.y = map_coord(pos.y);
-	bucketcounter = 0;
 
 	do
 	{
@@ -1995,7 +2055,7 @@ static int dangerFloodFill(int player)
 			{
 				continue;
 			}
-			aux = auxTile(npos.x, npos.y, MAX_PLAYERS + AUX_DANGERMAP);
+			aux = auxMap[npos.x + npos.y * mapWidth];
 			block = blockTile(pos.x, pos.y, AUX_DANGERMAP);
 			if (!(aux & AUXBITS_TEMPORARY) && !(aux & AUXBITS_THREAT) && (aux & AUXBITS_DANGER))
 			{
@@ -2012,14 +2072,14 @@ static int dangerFloodFill(int player)
 				}
 				else
 				{
-					auxClear(npos.x, npos.y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_DANGER);
+					auxMap[npos.x + npos.y * mapWidth] &= ~AUXBITS_DANGER;
 				}
-				auxSet(npos.x, npos.y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_TEMPORARY); // make sure we do not process it more than once
+				auxMap[npos.x + npos.y * mapWidth] |= AUXBITS_TEMPORARY; // make sure we do not process it more than once
 			}
 		}
 
 		// Clear danger
-		auxClear(pos.x, pos.y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_DANGER);
+		auxMap[pos.x + pos.y * mapWidth] &= ~AUXBITS_DANGER;
 
 		// Pop the last open node off the bucket list for the next iteration
 		if (bucketcounter)
@@ -2030,61 +2090,68 @@ static int dangerFloodFill(int player)
 		}
 	}
 	while (bucketcounter);
-	return 0;
 }
 
 // This function runs in a separate thread!
-static int dangerThreadFunc(WZ_DECL_UNUSED void *data)
+static int dangerThreadFunc(void *data)
 {
-	while (lastDangerPlayer != -1)
+	DangerWorker *worker = static_cast<DangerWorker *>(data);
+
+	wzSemaphoreWait(worker->startSemaphore);  // Go to sleep until needed.
+	while (!dangerWorkersQuit)
 	{
-		dangerFloodFill(lastDangerPlayer);	// Do the actual work
-		wzSemaphorePost(dangerDoneSemaphore);   // Signal that we are done
-		wzSemaphoreWait(dangerSemaphore);	// Go to sleep until needed.
+		for (int player = worker->index; player < dangerRoundPlayers; player += numDangerWorkers)
+		{
+			dangerFloodFill(player, psDangerMaps[player].get(), worker->floodbucket.data());	// Do the actual work
+		}
+		wzSemaphorePost(dangerDoneSemaphore);     // Signal that we are done
+		wzSemaphoreWait(worker->startSemaphore);  // Go to sleep until needed.
 	}
 	return 0;
 }
 
-static inline void threatUpdateTarget(int player, BASE_OBJECT *psObj, bool ground, bool air)
+/// Sets threat bits in the danger maps of players 0..numPlayers-1 that are hostile to, and can see, the given object.
+static inline void threatUpdateTarget(int numPlayers, BASE_OBJECT *psObj, bool ground, bool air)
 {
-	if (psObj->visible[player] || psObj->born == 2)
+	const uint8_t threatBits = (ground ? AUXBITS_THREAT : 0) | (air ? AUXBITS_AATHREAT : 0);
+
+	for (int player = 0; player < numPlayers; player++)
 	{
-		for (TILEPOS pos : psObj->watchedTiles)
+		if (aiCheckAlliances(player, psObj->player))
 		{
-			if (ground)
-			{
-				auxSet(pos.x, pos.y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_THREAT);	// set ground threat for this tile
-			}
-			if (air)
+			// No threat to friendly players
+			continue;
+		}
+		if (psObj->visible[player] || psObj->born == 2)
+		{
+			uint8_t *auxMap = psDangerMaps[player].get();
+			for (TILEPOS pos : psObj->watchedTiles)
 			{
-				auxSet(pos.x, pos.y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_AATHREAT);	// set air threat for this tile
+				auxMap[pos.x + pos.y * mapWidth] |= threatBits;	// set ground / air threat for this tile
 			}
 		}
 	}
 }
 
-static void threatUpdate(int player)
+/// Recalculates the threat bits for players 0..numPlayers-1, in a single pass over all armed objects.
+static void threatUpdate(int numPlayers)
 {
-	int i, weapon, x, y;
+	int i, weapon;
+	const size_t mapSize = static_cast<size_t>(mapWidth) * static_cast<size_t>(mapHeight);
 
-	// Step 1: Clear our threat bits
-	for (y = 0; y < mapHeight; y++)
+	// Step 1: Clear threat bits
+	for (int player = 0; player < numPlayers; player++)
 	{
-		for (x = 0; x < mapWidth; x++)
+		uint8_t *auxMap = psDangerMaps[player].get();
+		for (size_t tile = 0; tile < mapSize; tile++)
 		{
-			auxClear(x, y, MAX_PLAYERS + AUX_DANGERMAP, AUXBITS_THREAT | AUXBITS_AATHREAT);
+			auxMap[tile] &= ~(AUXBITS_THREAT | AUXBITS_AATHREAT);
 		}
 	}
 
 	// Step 2: Set threat bits
 	for (i = 0; i < MAX_PLAYERS; i++)
 	{
-		if (aiCheckAlliances(player, i))
-		{
-			// No need to iterate friendly objects
-			continue;
-		}
-
 		for (DROID* psDroid : apsDroidLists[i])
 		{
 			UBYTE mode = 0;
@@ -2104,7 +2171,7 @@ static void threatUpdate(int player)
 			}
 			if (mode > 0)
 			{
-				threatUpdateTarget(player, (BASE_OBJECT *)psDroid, mode & SHOOT_ON_GROUND, mode & SHOOT_IN_AIR);
+				threatUpdateTarget(numPlayers, (BASE_OBJECT *)psDroid, mode & SHOOT_ON_GROUND, mode & SHOOT_IN_AIR);
 			}
 		}
 
@@ -2122,72 +2189,164 @@ static void threatUpdate(int player)
 			}
 			if (mode > 0)
 			{
-				threatUpdateTarget(player, (BASE_OBJECT *)psStruct, mode & SHOOT_ON_GROUND, mode & SHOOT_IN_AIR);
+				threatUpdateTarget(numPlayers, (BASE_OBJECT *)psStruct, mode & SHOOT_ON_GROUND, mode & SHOOT_IN_AIR);
 			}
 		}
 	}
 }
 
+/// Copies the current aux and blocking maps of players 0..numPlayers-1 for the danger map threads, and recalculates their threat bits.
+static void dangerPrepareRound(int numPlayers)
+{
+	const size_t mapSize = static_cast<size_t>(mapWidth) * static_cast<size_t>(mapHeight);
+
+	memcpy(psBlockMap[AUX_DANGERMAP].get(), psBlockMap[0].get(), sizeof(uint8_t) * mapSize);
+	for (int player = 0; player < numPlayers; player++)
+	{
+		memcpy(psDangerMaps[player].get(), psAuxMap[player].get(), sizeof(uint8_t) * mapSize);
+	}
+	threatUpdate(numPlayers);
+	dangerRoundPlayers = numPlayers;
+}
+
+/// Waits for the danger map threads to finish the current round, if any.
+static void dangerWaitForRound()
+{
+	if (!dangerRoundPending)
+	{
+		return;
+	}
+	for (int i = 0; i < numDangerWorkers; i++)
+	{
+		wzSemaphoreWait(dangerDoneSemaphore);
+	}
+	dangerRoundPending = false;
+}
+
+/// Hands the finished danger and threat bits of the last round over to psAuxMap.
+static void dangerFinishRound()
+{
+	const size_t mapSize = static_cast<size_t>(mapWidth) * static_cast<size_t>(mapHeight);
+	const uint8_t mask = AUXBITS_DANGER | AUXBITS_THREAT | AUXBITS_AATHREAT;
+
+	for (int player = 0; player < dangerRoundPlayers; player++)
+	{
+		uint8_t *original = psAuxMap[player].get();
+		const uint8_t *cached = psDangerMaps[player].get();
+		for (size_t tile = 0; tile < mapSize; tile++)
+		{
+			original[tile] = original[tile] ^ ((original[tile] ^ cached[tile]) & mask);
+		}
+	}
+	dangerRoundPlayers = 0;
+}
+
+static void dangerShutdown()
+{
+	if (numDangerWorkers > 0)
+	{
+		dangerWaitForRound();
+		dangerWorkersQuit = true;
+		for (int i = 0; i < numDangerWorkers; i++)
+		{
+			wzSemaphorePost(dangerWorkers[i].startSemaphore);
+		}
+		for (int i = 0; i < numDangerWorkers; i++)
+		{
+			wzThreadJoin(dangerWorkers[i].thread);
+			wzSemaphoreDestroy(dangerWorkers[i].startSemaphore);
+			dangerWorkers[i] = DangerWorker();
+		}
+		wzSemaphoreDestroy(dangerDoneSemaphore);
+		dangerDoneSemaphore = nullptr;
+		numDangerWorkers = 0;
+	}
+	dangerWorkersQuit = false;
+	dangerRoundPending = false;
+	dangerRoundPlayers = 0;
+	for (auto &dangerMap : psDangerMaps)
+	{
+		dangerMap.reset();
+	}
+}
+
 void mapInit()
 {
 	int player;
-
-	free(floodbucket);
-	floodbucket = (struct floodtile *)malloc(mapWidth * mapHeight * sizeof(*floodbucket));
+	const size_t mapSize = static_cast<size_t>(mapWidth) * static_cast<size_t>(mapHeight);
 
 	lastDangerUpdate = 0;
-	lastDangerPlayer = -1;
 
-	// Start danger thread (not used for campaign for now - mission map swaps too icky)
-	ASSERT(dangerSemaphore == nullptr && dangerThread == nullptr, "Map data not cleaned up before starting!");
+	// Start danger threads (not used for campaign for now - mission map swaps too icky)
+	ASSERT(numDangerWorkers == 0 && dangerDoneSemaphore == nullptr, "Map data not cleaned up before starting!");
 	if (game.type == LEVEL_TYPE::SKIRMISH)
 	{
 		for (player = 0; player < MAX_PLAYERS; player++)
 		{
-			auxMapStore(player, AUX_DANGERMAP);
-			threatUpdate(player);
-			dangerFloodFill(player);
-			auxMapRestore(player, AUX_DANGERMAP, AUXBITS_DANGER | AUXBITS_THREAT | AUXBITS_AATHREAT);
+			psDangerMaps[player] = std::make_unique<uint8_t[]>(mapSize);
+		}
+		numDangerWorkers = std::max<int>(1, std::min<int>(DANGER_MAX_THREADS, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+		for (int i = 0; i < numDangerWorkers; i++)
+		{
+			dangerWorkers[i].index = i;
+			dangerWorkers[i].floodbucket.resize(mapSize);
 		}
-		lastDangerPlayer = 0;
-		dangerSemaphore = wzSemaphoreCreate(0);
+
+		dangerPrepareRound(MAX_PLAYERS);
+		for (player = 0; player < MAX_PLAYERS; player++)
+		{
+			dangerFloodFill(player, psDangerMaps[player].get(), dangerWorkers[0].floodbucket.data());
+		}
+		dangerFinishRound();
+
+		dangerWorkersQuit = false;
 		dangerDoneSemaphore = wzSemaphoreCreate(0);
-		dangerThread = wzThreadCreate(dangerThreadFunc, nullptr, "wzDanger");
-		wzThreadStart(dangerThread);
+		for (int i = 0; i < numDangerWorkers; i++)
+		{
+			dangerWorkers[i].startSemaphore = wzSemaphoreCreate(0);
+			dangerWorkers[i].thread = wzThreadCreate(dangerThreadFunc, &dangerWorkers[i], "wzDanger");
+			wzThreadStart(dangerWorkers[i].thread);
+		}
 	}
 }
 
 void mapUpdate()
 {
-	const uint16_t currentTime = gameTime / GAME_TICKS_PER_UPDATE;
-	int posX, posY;
+	const uint32_t currentUpdate = gameTime / GAME_TICKS_PER_UPDATE;
+	const uint16_t currentTime = currentUpdate;
 
-	for (posY = 0; posY < mapHeight; ++posY)
-		for (posX = 0; posX < mapWidth; ++posX)
-		{
-			MAPTILE *const tile = mapTile(posX, posY);
+	syncFireExpiryQueue();
+	while (!fireExpiryQueue.empty() && fireExpiryQueue.front().endUpdate <= currentUpdate)
+	{
+		const FireExpiry expiry = fireExpiryQueue.front();
+		std::pop_heap(fireExpiryQueue.begin(), fireExpiryQueue.end(), fireExpiresAfter);
+		fireExpiryQueue.pop_back();
 
-			if ((tile->tileInfoBits & BITS_ON_FIRE) != 0 && tile->fireEndTime == currentTime)
-			{
-				// Extinguish, tile, extinguish!
-				tile->tileInfoBits &= ~BITS_ON_FIRE;
+		// Entries are left behind when a tile is set on fire again for longer, so check the tile is really due
+		MAPTILE *const tile = mapTile(expiry.x, expiry.y);
+		if ((tile->tileInfoBits & BITS_ON_FIRE) != 0 && tile->fireEndTime == currentTime)
+		{
+			// Extinguish, tile, extinguish!
+			tile->tileInfoBits &= ~BITS_ON_FIRE;
 
-				syncDebug("Extinguished tile{%d, %d}", posX, posY);
-			}
+			syncDebug("Extinguished tile{%d, %d}", expiry.x, expiry.y);
 		}
+	}
 
-	if (gameTime > lastDangerUpdate + GAME_TICKS_FOR_DANGER && game.type == LEVEL_TYPE::SKIRMISH)
+	if (gameTime > lastDangerUpdate + GAME_TICKS_FOR_DANGER && game.type == LEVEL_TYPE::SKIRMISH && numDangerWorkers > 0)
 	{
 		syncDebug("Do danger maps.");
 		lastDangerUpdate = gameTime;
 
-		// Lock if previous job not done yet
-		wzSemaphoreWait(dangerDoneSemaphore);
+		// Lock if previous round not done yet
+		dangerWaitForRound();
+		dangerFinishRound();
 
-		auxMapRestore(lastDangerPlayer, AUX_DANGERMAP, AUXBITS_THREAT | AUXBITS_AATHREAT | AUXBITS_DANGER);
-		lastDangerPlayer = (lastDangerPlayer + 1) % game.maxPlayers;
-		auxMapStore(lastDangerPlayer, AUX_DANGERMAP);
-		threatUpdate(lastDangerPlayer);
-		wzSemaphorePost(dangerSemaphore);
+		dangerPrepareRound(game.maxPlayers);
+		dangerRoundPending = true;
+		for (int i = 0; i < numDangerWorkers; i++)
+		{
+			wzSemaphorePost(dangerWorkers[i].startSemaphore);
+		}
 	}
 }
@@ -567,6 +567,8 @@ extern SDWORD scrollMinX, scrollMaxX, scrollMinY, scrollMaxY;
 void mapFloodFillContinents();
 
 void tileSetFire(int32_t x, int32_t y, uint32_t duration);
+/// Must be called whenever psMapTiles is replaced or swapped (e.g. by the mission code), so the fire expiry queue is rebuilt from the new map.
+void mapTilesReplaced();
 bool fireOnLocation(unsigned int x, unsigned int y);
 
 /**
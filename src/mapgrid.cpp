@@ -36,6 +36,7 @@ static PointTree *gridPointTree = nullptr;  // A quad-tree-like object.
 static PointTree::Filter *gridFiltersUnseen;
 static PointTree::Filter *gridFiltersDroidsByPlayer;
 static PointTree::Filter *gridFiltersDroidsRepairCandidates;
+static PointTree::Filter *gridFilterDroids;  // Shared by all players, since droids are droids for everyone.
 
 // initialise the grid system
 bool gridInitialise()
@@ -45,6 +46,7 @@ bool gridInitialise()
 	gridFiltersUnseen = new PointTree::Filter[MAX_PLAYERS];
 	gridFiltersDroidsByPlayer = new PointTree::Filter[MAX_PLAYERS];
 	gridFiltersDroidsRepairCandidates = new PointTree::Filter[MAX_PLAYERS];
+	gridFilterDroids = new PointTree::Filter;
 
 	return true;  // Yay, nothing failed!
 }
@@ -100,6 +102,7 @@ void gridReset()
 		gridFiltersDroidsByPlayer[player].reset(*gridPointTree);
 		gridFiltersDroidsRepairCandidates[player].reset(*gridPointTree);
 	}
+	gridFilterDroids->reset(*gridPointTree);
 }
 
 // shutdown the grid system
@@ -111,6 +114,8 @@ void gridShutDown()
 	gridFiltersUnseen = nullptr;
 	delete[] gridFiltersDroidsByPlayer;
 	gridFiltersDroidsByPlayer = nullptr;
+	delete gridFilterDroids;
+	gridFilterDroids = nullptr;
 }
 
 static bool isInRadius(int32_t x, int32_t y, uint32_t radius)
@@ -192,6 +197,19 @@ GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t
 	return gridStartIterateFilteredArea(x, y, x2, y2, ConditionTrue());
 }
 
+struct ConditionDroids
+{
+	bool test(BASE_OBJECT *obj) const
+	{
+		return obj->type == OBJ_DROID;
+	}
+};
+
+GridList const &gridStartIterateDroids(int32_t x, int32_t y, uint32_t radius)
+{
+	return gridStartIterateFiltered(x, y, radius, gridFilterDroids, ConditionDroids());
+}
+
 struct ConditionDroidsByPlayer
 {
 	ConditionDroidsByPlayer(int32_t player_) : player(player_) {}
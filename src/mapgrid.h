@@ -43,6 +43,11 @@ GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius);
 /// Find all objects within radius.
 GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t y2);
 
+/// Find all objects within radius where object->type == OBJ_DROID.
+/// Returns the same droids, in the same order, as gridStartIterate, but skips other objects cheaply when called repeatedly,
+/// so should be used for the per-droid collision queries in dense groups.
+GridList const &gridStartIterateDroids(int32_t x, int32_t y, uint32_t radius);
+
 /// Find all objects within radius where object->type == OBJ_DROID && object->player == player.
 GridList const &gridStartIterateDroidsByPlayer(int32_t x, int32_t y, uint32_t radius, int player);
 
@@ -345,12 +345,14 @@ bool missionShutDown()
 			apsExtractorLists[inc] = std::move(mission.apsExtractorLists[inc]);
 			mission.apsExtractorLists[inc].clear();
 		}
+		objmemListsChanged();
 		apsSensorList[0] = std::move(mission.apsSensorList[0]);
 		apsOilList[0] = std::move(mission.apsOilList[0]);
 		mission.apsSensorList[0].clear();
 		mission.apsOilList[0].clear();
 
 		psMapTiles = std::move(mission.psMapTiles);
+		mapTilesReplaced();
 		mapWidth = mission.mapWidth;
 		mapHeight = mission.mapHeight;
 		for (int i = 0; i < ARRAY_SIZE(mission.psBlockMap); ++i)
@@ -769,6 +771,7 @@ static void saveMissionData()
 
 	//save the mission data
 	mission.psMapTiles = std::move(psMapTiles);
+	mapTilesReplaced();
 	mission.mapWidth = mapWidth;
 	mission.mapHeight = mapHeight;
 	for (int i = 0; i < ARRAY_SIZE(mission.psBlockMap); ++i)
@@ -864,6 +867,7 @@ void restoreMissionData()
 		apsExtractorLists[inc] = std::move(mission.apsExtractorLists[inc]);
 		mission.apsExtractorLists[inc].clear();
 	}
+	objmemListsChanged();
 	apsSensorList[0] = std::move(mission.apsSensorList[0]);
 	apsOilList[0] = std::move(mission.apsOilList[0]);
 	mission.apsSensorList[0].clear();
@@ -871,6 +875,7 @@ void restoreMissionData()
 	//swap mission data over
 
 	psMapTiles = std::move(mission.psMapTiles);
+	mapTilesReplaced();
 
 	mapWidth = mission.mapWidth;
 	mapHeight = mission.mapHeight;
@@ -932,6 +937,7 @@ void saveMissionLimboData()
 		return IterationResult::CONTINUE_ITERATION;
 	});
 	apsDroidLists[selectedPlayer].clear();
+	objmemListsChanged();
 
 	// any selectedPlayer's factories/research need to be put on holdProduction/holdresearch
 	for (STRUCTURE* psStruct : apsStructLists[selectedPlayer])
@@ -1084,6 +1090,7 @@ void saveCampaignData()
 		// Reserve the droids for selected player for start of next campaign
 		mission.apsDroidLists[selectedPlayer] = std::move(apsDroidLists[selectedPlayer]);
 		apsDroidLists[selectedPlayer].clear();
+		objmemListsChanged();
 		for (DROID* psDroid : mission.apsDroidLists[selectedPlayer])
 		{
 			//cam change add droid
@@ -1382,6 +1389,7 @@ void swapMissionPointers()
 	debug(LOG_SAVE, "called");
 
 	std::swap(psMapTiles, mission.psMapTiles);
+	mapTilesReplaced();
 	std::swap(mapWidth,   mission.mapWidth);
 	std::swap(mapHeight,  mission.mapHeight);
 	for (int i = 0; i < ARRAY_SIZE(mission.psBlockMap); ++i)
@@ -1406,6 +1414,7 @@ void swapMissionPointers()
 		std::swap(apsFlagPosLists[inc],   mission.apsFlagPosLists[inc]);
 		std::swap(apsExtractorLists[inc], mission.apsExtractorLists[inc]);
 	}
+	objmemListsChanged();
 	std::swap(apsSensorList[0], mission.apsSensorList[0]);
 	std::swap(apsOilList[0],    mission.apsOilList[0]);
 }
@@ -2970,6 +2979,7 @@ void missionDestroyObjects()
 
 			//clear out the mission lists as well to make sure no Transporters exist
 			apsDroidLists[Player] = std::move(mission.apsDroidLists[Player]);
+			objmemListsChanged();
 
 			mutating_list_iterate(apsDroidLists[Player], [](DROID* psDroid)
 			{
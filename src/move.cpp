@@ -425,7 +425,7 @@ static void moveShuffleDroid(DROID *psDroid, Vector2i s)
 
 	// find any droids that could block the shuffle
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, SHUFFLE_DIST);
+	gridList = gridStartIterateDroids(psDroid->pos.x, psDroid->pos.y, SHUFFLE_DIST);
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
 		DROID *psCurr = castDroid(*gi);
@@ -748,7 +748,7 @@ static void moveCheckSquished(DROID *psDroid, int32_t emx, int32_t emy)
 	const int32_t   my = gameTimeAdjustedAverage(emy, EXTRA_PRECISION);
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
+	gridList = gridStartIterateDroids(psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
 		BASE_OBJECT *psObj = *gi;
@@ -1192,7 +1192,7 @@ static void moveCalcDroidSlide(DROID *psDroid, int *pmx, int *pmy)
 	droidR = moveObjRadius((BASE_OBJECT *)psDroid);
 	BASE_OBJECT *psObst = nullptr;
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
+	gridList = gridStartIterateDroids(psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
 		BASE_OBJECT *psObj = *gi;
@@ -1317,7 +1317,7 @@ static Vector2i moveGetObstacleVector(DROID *psDroid, Vector2i dest)
 
 	// scan the neighbours for obstacles
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, AVOID_DIST);
+	gridList = gridStartIterateDroids(psDroid->pos.x, psDroid->pos.y, AVOID_DIST);
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
 		if (*gi == psDroid)
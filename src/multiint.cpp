@@ -74,6 +74,7 @@
 #include "objmem.h"
 #include "gateway.h"
 #include "clparse.h"
+#include "benchmark.h"
 #include "configuration.h"
 #include "intdisplay.h"
 #include "design.h"
@@ -4731,6 +4732,10 @@ void WzMultiplayerOptionsTitleUI::addPlayerBox(bool players)
 static void SendFireUp()
 {
 	uint32_t randomSeed = rand();  // Pick a random random seed for the synchronised random number generator.
+	if (benchmarkEnabled())
+	{
+		randomSeed = benchmarkSeed();  // Benchmark runs must simulate the same game every time.
+	}
 
 	debug(LOG_INFO, "Sending NET_FIREUP");
 
@@ -90,6 +90,7 @@
 #include "multilobbycommands.h"
 #include "hci/teamstrategy.h"
 #include "hci/quickchat.h"
+#include "benchmark.h"
 
 // ////////////////////////////////////////////////////////////////////////////
 // ////////////////////////////////////////////////////////////////////////////
@@ -1277,6 +1278,7 @@ bool recvMessage()
 				}
 				addConsoleMessage(_("REPLAY HAS ENDED"), CENTRE_JUSTIFY, SYSTEM_MESSAGE, false, MAX_CONSOLE_MESSAGE_DURATION);
 				addConsoleMessage(_("(Press ESC to quit.)"), CENTRE_JUSTIFY, SYSTEM_MESSAGE, false, MAX_CONSOLE_MESSAGE_DURATION);
+				benchmarkReplayEnded();
 				break;
 			default:
 				processedMessage1 = false;
@@ -1576,14 +1578,24 @@ bool sendResearchStatus(const STRUCTURE *psBuilding, uint32_t index, uint8_t pla
 	return true;
 }
 
+static bool isResearchingIndex(const STRUCTURE *psBuilding, unsigned index)
+{
+	return psBuilding->pStructureType->type == REF_RESEARCH
+		&& ((RESEARCH_FACILITY *)psBuilding->pFunctionality)->psSubject
+		&& ((RESEARCH_FACILITY *)psBuilding->pFunctionality)->psSubject->ref - STAT_RESEARCH == index;
+}
+
 STRUCTURE *findResearchingFacilityByResearchIndex(const PerPlayerStructureLists& pList, unsigned player, unsigned index)
 {
+	if (&pList == &apsStructLists)
+	{
+		return findResearchingFacilityByResearchIndex(player, index);
+	}
+
 	// Go through the structs to find the one doing this topic
 	for (STRUCTURE *psBuilding : pList[player])
 	{
-		if (psBuilding->pStructureType->type == REF_RESEARCH
-			&& ((RESEARCH_FACILITY *)psBuilding->pFunctionality)->psSubject
-			&& ((RESEARCH_FACILITY *)psBuilding->pFunctionality)->psSubject->ref - STAT_RESEARCH == index)
+		if (isResearchingIndex(psBuilding, index))
 		{
 			return psBuilding;
 		}
@@ -1593,7 +1605,15 @@ STRUCTURE *findResearchingFacilityByResearchIndex(const PerPlayerStructureLists&
 
 STRUCTURE *findResearchingFacilityByResearchIndex(unsigned player, unsigned index)
 {
-	return findResearchingFacilityByResearchIndex(apsStructLists, player, index);
+	// Only research facilities can be doing this topic
+	for (STRUCTURE *psBuilding : structuresOfType(player, REF_RESEARCH))
+	{
+		if (isResearchingIndex(psBuilding, index))
+		{
+			return psBuilding;
+		}
+	}
+	return nullptr;  // Not found.
 }
 
 bool recvResearchStatus(NETQUEUE queue)
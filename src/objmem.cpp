@@ -70,6 +70,22 @@ PerPlayerFlagPositionLists apsFlagPosLists;
 /* The list of destroyed objects */
 DestroyedObjectsList psDestroyedObj;
 
+/* Secondary indices, see structuresOfType() and constructionDroids() */
+struct PlayerStructureIndex
+{
+	bool valid = false;
+	size_t listSize = 0;
+	std::array<std::vector<STRUCTURE *>, NUM_DIFF_BUILDINGS> byType;
+};
+struct PlayerDroidIndex
+{
+	bool valid = false;
+	size_t listSize = 0;
+	std::vector<DROID *> constructionDroids;
+};
+static std::array<PlayerStructureIndex, MAX_PLAYERS> structureIndex;
+static std::array<PlayerDroidIndex, MAX_PLAYERS> droidIndex;
+
 /* Forward function declarations */
 #ifdef DEBUG
 static void objListIntegCheck();
@@ -360,6 +376,28 @@ uint32_t generateSynchronisedObjectId()
 	return ret;
 }
 
+/* Invalidate the secondary index of a list, if it has one */
+template <typename OBJECT>
+static inline void objListChanged(PerPlayerObjectLists<OBJECT, MAX_PLAYERS> const &, int)
+{
+}
+
+static inline void objListChanged(PerPlayerStructureLists const &list, int player)
+{
+	if (&list == &apsStructLists)
+	{
+		structureIndex[player].valid = false;
+	}
+}
+
+static inline void objListChanged(PerPlayerDroidLists const &list, int player)
+{
+	if (&list == &apsDroidLists)
+	{
+		droidIndex[player].valid = false;
+	}
+}
+
 /* Add the object to its list
  * \param list is a pointer to the object list
  */
@@ -370,6 +408,7 @@ static inline void addObjectToList(PerPlayerObjectLists<OBJECT, MAX_PLAYERS>& li
 
 	// Prepend the object to the top of the list
 	list[player].emplace_front(object);
+	objListChanged(list, player);
 }
 
 /* Add the object to its list
@@ -402,6 +441,7 @@ static inline void destroyObject(PerPlayerObjectLists<OBJECT, MAX_PLAYERS>& list
 	if (it != list[object->player].end())
 	{
 		list[object->player].erase(it);
+		objListChanged(list, object->player);
 
 		// Prepend the object to the destruction list
 		psDestroyedObj.emplace_front((BASE_OBJECT*)object);
@@ -425,6 +465,7 @@ static inline void removeObjectFromList(PerPlayerObjectLists<OBJECT, MAX_PLAYERS
 	auto it = std::find(list[player].begin(), list[player].end(), object);
 	ASSERT_OR_RETURN(, it != list[player].end(), "Object %p not found in list", static_cast<void*>(object));
 	list[player].erase(it);
+	objListChanged(list, player);
 }
 
 /* Remove an object from the relevant function list. An object can only be in one function list at a time!
@@ -461,6 +502,7 @@ static inline void releaseAllObjectsInList(PerPlayerObjectLists<OBJECT, MAX_PLAY
 		}
 		list.clear();
 	}
+	objmemListsChanged();
 }
 
 /***************************************************************************************
@@ -597,6 +639,7 @@ static void freeAllEntitiesImpl(PerPlayerObjectLists<Entity, PlayerCount>& entit
 		}
 		list.clear();
 	}
+	objmemListsChanged();
 }
 
 /* Remove all droids */
@@ -1152,3 +1195,62 @@ void objCount(int *droids, int *structures, int *features)
 
 	*features += apsFeatureLists[0].size();
 }
+
+const std::vector<STRUCTURE *> &structuresOfType(unsigned player, STRUCTURE_TYPE type)
+{
+	static const std::vector<STRUCTURE *> none;
+	ASSERT_OR_RETURN(none, player < MAX_PLAYERS, "Invalid player %u", player);
+	ASSERT_OR_RETURN(none, type < NUM_DIFF_BUILDINGS, "Invalid structure type %d", (int)type);
+
+	PlayerStructureIndex &index = structureIndex[player];
+	ASSERT(!index.valid || index.listSize == apsStructLists[player].size(), "Structure list of player %u changed without objmemListsChanged()", player);
+	if (!index.valid || index.listSize != apsStructLists[player].size())
+	{
+		for (auto &structures : index.byType)
+		{
+			structures.clear();
+		}
+		for (STRUCTURE *psStruct : apsStructLists[player])
+		{
+			index.byType[psStruct->pStructureType->type].push_back(psStruct);
+		}
+		index.listSize = apsStructLists[player].size();
+		index.valid = true;
+	}
+	return index.byType[type];
+}
+
+const std::vector<DROID *> &constructionDroids(unsigned player)
+{
+	static const std::vector<DROID *> none;
+	ASSERT_OR_RETURN(none, player < MAX_PLAYERS, "Invalid player %u", player);
+
+	PlayerDroidIndex &index = droidIndex[player];
+	ASSERT(!index.valid || index.listSize == apsDroidLists[player].size(), "Droid list of player %u changed without objmemListsChanged()", player);
+	if (!index.valid || index.listSize != apsDroidLists[player].size())
+	{
+		index.constructionDroids.clear();
+		for (DROID *psDroid : apsDroidLists[player])
+		{
+			if (psDroid->isConstructionDroid())
+			{
+				index.constructionDroids.push_back(psDroid);
+			}
+		}
+		index.listSize = apsDroidLists[player].size();
+		index.valid = true;
+	}
+	return index.constructionDroids;
+}
+
+void objmemListsChanged()
+{
+	for (auto &index : structureIndex)
+	{
+		index.valid = false;
+	}
+	for (auto &index : droidIndex)
+	{
+		index.valid = false;
+	}
+}
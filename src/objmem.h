@@ -28,6 +28,7 @@
 
 #include <array>
 #include <list>
+#include <vector>
 
 /* The lists of objects allocated */
 template <typename ObjectType, unsigned PlayerCount>
@@ -153,6 +154,15 @@ UDWORD getRepairIdFromFlag(const FLAG_POSITION *psFlag);
 
 void objCount(int *droids, int *structures, int *features);
 
+/// Per-player secondary indices into apsStructLists and apsDroidLists, rebuilt on first use after the lists change.
+/// Entries are in list order, so the first entry is the one a linear scan of the list would have found first.
+const std::vector<STRUCTURE *> &structuresOfType(unsigned player, STRUCTURE_TYPE type);
+/// The player's construction droids (see isConstructionDroid()) in apsDroidLists.
+const std::vector<DROID *> &constructionDroids(unsigned player);
+/// Invalidates the indices. Must be called after moving, swapping or clearing apsStructLists / apsDroidLists
+/// directly, rather than through the functions in this file.
+void objmemListsChanged();
+
 #ifdef DEBUG
 void checkFactoryFlags();
 #endif
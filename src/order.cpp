@@ -3044,37 +3044,23 @@ DROID *FindATransporter(DROID const *embarkee)
 }
 
 
-/** Given a factory type, this function runs though all player's structures to check if any is of factory type. Returns the structure if any was found, and NULL else.*/
+/** Given a factory type, this function checks whether the player has any structure of factory type. Returns the structure if any was found, and NULL else.*/
 static STRUCTURE *FindAFactory(UDWORD player, UDWORD factoryType)
 {
 	ASSERT_PLAYER_OR_RETURN(nullptr, player);
 
-	for (STRUCTURE *psStruct : apsStructLists[player])
-	{
-		if (psStruct->pStructureType->type == factoryType)
-		{
-			return psStruct;
-		}
-	}
-
-	return nullptr;
+	const std::vector<STRUCTURE *> &factories = structuresOfType(player, (STRUCTURE_TYPE)factoryType);
+	return factories.empty() ? nullptr : factories.front();
 }
 
 
-/** This function runs though all player's structures to check if any of then is a repair facility. Returns the structure if any was found, and NULL else.*/
+/** This function checks whether the player has any repair facility. Returns the structure if any was found, and NULL else.*/
 static STRUCTURE *FindARepairFacility(unsigned player)
 {
 	ASSERT_PLAYER_OR_RETURN(nullptr, player);
 
-	for (STRUCTURE *psStruct : apsStructLists[player])
-	{
-		if (psStruct->pStructureType->type == REF_REPAIR_FACILITY)
-		{
-			return psStruct;
-		}
-	}
-
-	return nullptr;
+	const std::vector<STRUCTURE *> &repairFacilities = structuresOfType(player, REF_REPAIR_FACILITY);
+	return repairFacilities.empty() ? nullptr : repairFacilities.front();
 }
 
 
@@ -39,6 +39,31 @@
 #include <ittnotify.h>
 #endif
 
+#ifdef WZ_PROFILING_TRACE
+#include "lib/framework/frame.h"
+#include "lib/framework/file.h"
+#include "lib/framework/physfs_ext.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  define WZ_TRACE_USE_TSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define WZ_TRACE_USE_TSC
+#endif
+
+// Number of events kept per thread (older events are overwritten).
+#define TRACE_EVENTS_PER_THREAD 16384
+#define TRACE_DIRECTORY "traces"
+#endif
+
 namespace profiling
 {
 
@@ -94,11 +119,226 @@ Domain::~Domain()
 // Global domain for warzone.
 Domain wzRootDomain{"warzone2100"};
 
+#ifdef WZ_PROFILING_TRACE
+
+struct TraceEvent
+{
+	const char* domain;
+	const char* object;
+	const char* name;
+	uint64_t start;
+	uint64_t end;   ///< Equal to start for marks.
+};
+
+/// Ring buffer written only by its owning thread. traceDump() may read it concurrently,
+/// and discards any slots that could have been overwritten while it was copying.
+/// When its thread exits the buffer is kept (with its events) and handed to the next new thread,
+/// so tid identifies the buffer, and one trace row can show several short-lived threads in turn.
+struct TraceThreadBuffer
+{
+	explicit TraceThreadBuffer(uint32_t tid) : tid(tid) {}
+
+	uint32_t tid;
+	bool inUse = true;  ///< Guarded by traceBuffersMutex.
+	std::atomic<uint64_t> head{0};
+	TraceEvent events[TRACE_EVENTS_PER_THREAD];
+};
+
+static std::mutex traceBuffersMutex; // Only taken when a thread records its first event, and when dumping.
+static std::vector<std::unique_ptr<TraceThreadBuffer>> traceBuffers;
+static std::string traceDumpOnExitFilename;
+
+static inline uint64_t traceTimestamp()
+{
+#ifdef WZ_TRACE_USE_TSC
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/// Pairs of (timestamp, steady_clock) used to convert timestamps to microseconds.
+struct TraceClockSample
+{
+	uint64_t ticks;
+	std::chrono::steady_clock::time_point time;
+
+	static TraceClockSample now()
+	{
+		return {traceTimestamp(), std::chrono::steady_clock::now()};
+	}
+};
+static const TraceClockSample traceClockOrigin = TraceClockSample::now();
+
+/// The calling thread's buffer, which is released for reuse when the thread exits.
+struct TraceThreadBufferOwner
+{
+	~TraceThreadBufferOwner()
+	{
+		if (buffer)
+		{
+			std::lock_guard<std::mutex> guard(traceBuffersMutex);
+			buffer->inUse = false;
+		}
+	}
+
+	TraceThreadBuffer *buffer = nullptr;
+};
+
+static TraceThreadBuffer *traceThreadBuffer()
+{
+	static thread_local TraceThreadBufferOwner owner;
+	if (owner.buffer == nullptr)
+	{
+		std::lock_guard<std::mutex> guard(traceBuffersMutex);
+		auto it = std::find_if(traceBuffers.begin(), traceBuffers.end(), [](const std::unique_ptr<TraceThreadBuffer> &buffer) { return !buffer->inUse; });
+		if (it != traceBuffers.end())
+		{
+			owner.buffer = it->get();
+			owner.buffer->inUse = true;
+		}
+		else
+		{
+			traceBuffers.emplace_back(new TraceThreadBuffer(static_cast<uint32_t>(traceBuffers.size() + 1)));
+			owner.buffer = traceBuffers.back().get();
+		}
+	}
+	return owner.buffer;
+}
+
+static inline void traceRecord(const Domain *domain, const char *object, const char *name, uint64_t start, uint64_t end)
+{
+	TraceThreadBuffer *buffer = traceThreadBuffer();
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	TraceEvent &event = buffer->events[head % TRACE_EVENTS_PER_THREAD];
+	event.domain = domain->getInternal()->name.c_str();
+	event.object = object;
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+static void traceAppendString(std::string &out, const char *str)
+{
+	out += '"';
+	for (; *str; ++str)
+	{
+		char c = *str;
+		if (c == '"' || c == '\\')
+		{
+			out += '\\';
+			out += c;
+		}
+		else if (static_cast<unsigned char>(c) >= 0x20)
+		{
+			out += c;
+		}
+	}
+	out += '"';
+}
+
+bool traceDump(const char *filename)
+{
+	ASSERT_OR_RETURN(false, filename && *filename, "No trace filename");
+	ASSERT_OR_RETURN(false, strchr(filename, '/') == nullptr && strchr(filename, '\\') == nullptr && strcmp(filename, "..") != 0, "Invalid trace filename: %s", filename);
+
+	const TraceClockSample clockNow = TraceClockSample::now();
+	const double elapsedUs = std::chrono::duration<double, std::micro>(clockNow.time - traceClockOrigin.time).count();
+	const double ticksPerUs = (elapsedUs > 0 && clockNow.ticks > traceClockOrigin.ticks) ? (clockNow.ticks - traceClockOrigin.ticks) / elapsedUs : 1000.0;
+
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	size_t eventCount = 0;
+	char tmp[128];
+	std::vector<TraceEvent> events;
+	std::lock_guard<std::mutex> guard(traceBuffersMutex);
+	for (const auto &buffer : traceBuffers)
+	{
+		uint64_t headBefore = buffer->head.load(std::memory_order_acquire);
+		uint64_t first = (headBefore > TRACE_EVENTS_PER_THREAD) ? headBefore - TRACE_EVENTS_PER_THREAD : 0;
+		events.clear();
+		for (uint64_t i = first; i < headBefore; ++i)
+		{
+			events.push_back(buffer->events[i % TRACE_EVENTS_PER_THREAD]);
+		}
+		// Anything the owning thread may have overwritten while we were copying is unreliable. It fills slot
+		// headAfter before publishing headAfter + 1, so events from headAfter + 1 - TRACE_EVENTS_PER_THREAD on are intact.
+		uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+		uint64_t firstReliable = std::max<uint64_t>(headAfter + 1, TRACE_EVENTS_PER_THREAD) - TRACE_EVENTS_PER_THREAD;
+		size_t skip = static_cast<size_t>(std::min<uint64_t>(std::max(firstReliable, first) - first, events.size()));
+
+		for (size_t i = skip; i < events.size(); ++i)
+		{
+			const TraceEvent &event = events[i];
+			if (event.start < traceClockOrigin.ticks)
+			{
+				continue;
+			}
+			json += (eventCount++ == 0) ? "{\"name\":" : ",\n{\"name\":";
+			if (event.object)
+			{
+				std::string fullName = std::string(event.object) + "::" + event.name;
+				traceAppendString(json, fullName.c_str());
+			}
+			else
+			{
+				traceAppendString(json, event.name);
+			}
+			json += ",\"cat\":";
+			traceAppendString(json, event.domain);
+			const double ts = (event.start - traceClockOrigin.ticks) / ticksPerUs;
+			if (event.end == event.start)
+			{
+				snprintf(tmp, sizeof(tmp), ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}", ts, buffer->tid);
+			}
+			else
+			{
+				const double dur = (event.end - event.start) / ticksPerUs;
+				snprintf(tmp, sizeof(tmp), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}", ts, dur, buffer->tid);
+			}
+			json += tmp;
+		}
+	}
+	json += "]}\n";
+
+	PHYSFS_mkdir(TRACE_DIRECTORY);
+	std::string path = std::string(TRACE_DIRECTORY "/") + filename;
+	if (!saveFile(path.c_str(), json.data(), static_cast<UDWORD>(json.size())))
+	{
+		debug(LOG_ERROR, "Failed to write trace: %s", path.c_str());
+		return false;
+	}
+	debug(LOG_INFO, "Wrote %zu trace events to %s", eventCount, path.c_str());
+	return true;
+}
+
+void traceSetDumpOnExit(const char *filename)
+{
+	traceDumpOnExitFilename = filename ? filename : "";
+}
+
+void traceShutdown()
+{
+	if (!traceDumpOnExitFilename.empty())
+	{
+		traceDump(traceDumpOnExitFilename.c_str());
+		traceDumpOnExitFilename.clear();
+	}
+}
+
+#endif // WZ_PROFILING_TRACE
+
 Scope::Scope(const Domain *domain, const char *name)
 	:m_domain(domain)
 {
 	if (m_domain && name)
 	{
+		#ifdef WZ_PROFILING_TRACE
+		{
+			m_name = name;
+			m_start = traceTimestamp();
+		}
+		#endif
 		#ifdef WZ_PROFILING_NVTX
 		{
 			nvtxRangePushA(name);
@@ -121,6 +361,13 @@ Scope::Scope(const Domain *domain, const char *object, const char *name)
 	{
 		static char tmpBuffer[255];
 		std::snprintf(tmpBuffer, sizeof(tmpBuffer), "%s::%s", object, name);
+		#ifdef WZ_PROFILING_TRACE
+		{
+			m_object = object;
+			m_name = name;
+			m_start = traceTimestamp();
+		}
+		#endif
 		#ifdef WZ_PROFILING_NVTX
 		{
 			nvtxRangePushA(tmpBuffer);
@@ -139,6 +386,13 @@ Scope::Scope(const Domain *domain, const char *object, const char *name)
 Scope::~Scope()
 {
 	if (m_domain) {
+#ifdef WZ_PROFILING_TRACE
+		if (m_name)
+		{
+			uint64_t end = traceTimestamp();
+			traceRecord(m_domain, m_object, m_name, m_start, (end != m_start) ? end : end + 1);
+		}
+#endif
 #ifdef WZ_PROFILING_NVTX
 		nvtxRangePop();
 #endif
@@ -153,6 +407,12 @@ void mark(const Domain *domain, const char *mark)
 {
 	if (!domain || !mark)
 		return;
+	#ifdef WZ_PROFILING_TRACE
+	{
+		uint64_t now = traceTimestamp();
+		traceRecord(domain, nullptr, mark, now, now);
+	}
+	#endif
 	#ifdef WZ_PROFILING_NVTX
 	{
 		nvtxEventAttributes_t eventAttrib = {};
@@ -178,6 +438,12 @@ void mark(const Domain *domain, const char *object, const char *mark)
 	static char tmpBuffer[255];
 	std::snprintf(tmpBuffer, sizeof(tmpBuffer), "%s::%s", object, mark);
 
+	#ifdef WZ_PROFILING_TRACE
+	{
+		uint64_t now = traceTimestamp();
+		traceRecord(domain, object, mark, now, now);
+	}
+	#endif
 	#ifdef WZ_PROFILING_NVTX
 	{
 		nvtxEventAttributes_t eventAttrib = {};
@@ -64,6 +64,11 @@ public:
 
 private:
 	const Domain* m_domain = nullptr;
+#ifdef WZ_PROFILING_TRACE
+	const char* m_object = nullptr;
+	const char* m_name = nullptr;
+	uint64_t m_start = 0;
+#endif
 };
 
 extern Domain wzRootDomain;
@@ -71,6 +76,19 @@ extern Domain wzRootDomain;
 void mark(const Domain *domain, const char *mark);
 void mark(const Domain *domain, const char *object, const char *mark);
 
+#ifdef WZ_PROFILING_TRACE
+/// Built-in trace backend.
+/// Each thread records finished scopes and marks into its own fixed-size ring buffer,
+/// so the most recent events are always available without any external tooling.
+
+/// Write the buffered events to traces/<filename> in the write directory, as Chrome trace JSON
+/// (can be opened with chrome://tracing or ui.perfetto.dev).
+bool traceDump(const char *filename);
+/// Request a traceDump() to the specified file when the game shuts down.
+void traceSetDumpOnExit(const char *filename);
+void traceShutdown();
+#endif
+
 }
 
 #define WZ_PROFILE_SCOPE(name) profiling::Scope mark_##name(&profiling::wzRootDomain, #name);
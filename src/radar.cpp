@@ -19,6 +19,8 @@
 */
 #include <string.h>
 #include <cstdlib>
+#include <climits>
+#include <vector>
 
 #include "lib/framework/frame.h"
 #include "lib/framework/fixedpoint.h"
@@ -62,7 +64,7 @@
 #define HIT_NOTIFICATION	(GAME_TICKS_PER_SEC * 2)
 #define RADAR_FRAME_SKIP	10
 
-static void applyMinimapOverlay();
+static void applyMinimapOverlay(size_t *changedX0, size_t *changedY0, size_t *changedX1, size_t *changedY1);
 
 bool bEnemyAllyRadarColor = false;     			/**< Enemy/ally radar color. */
 RADAR_DRAW_MODE	radarDrawMode = RADAR_MODE_DEFAULT;	/**< Current mini-map mode. */
@@ -155,6 +157,37 @@ static const UDWORD BLINK_INTERVAL = GAME_TICKS_PER_SEC / 1;
 static const UDWORD BLINK_HALF_INTERVAL = BLINK_INTERVAL / 2;
 static const float OVERLAY_OPACITY = 0.5f;
 
+/// Everything besides the tiles themselves that the radar tile colours depend on. If any of it changes, every tile is recoloured.
+struct RadarColourInputs
+{
+	const MAPTILE *mapTiles = nullptr;
+	int mapWidth = 0, mapHeight = 0;
+	int scrollMinX = 0, scrollMinY = 0, scrollMaxX = 0, scrollMaxY = 0;
+	RADAR_DRAW_MODE drawMode = RADAR_MODE_DEFAULT;
+	bool reveal = false;
+	bool godMode = false;
+	unsigned selectedPlayer = 0;
+	PlayerMask alliance = 0;
+	PlayerMask satuplink = 0;
+
+	bool operator ==(const RadarColourInputs &o) const
+	{
+		return mapTiles == o.mapTiles && mapWidth == o.mapWidth && mapHeight == o.mapHeight
+		       && scrollMinX == o.scrollMinX && scrollMinY == o.scrollMinY && scrollMaxX == o.scrollMaxX && scrollMaxY == o.scrollMaxY
+		       && drawMode == o.drawMode && reveal == o.reveal && godMode == o.godMode
+		       && selectedPlayer == o.selectedPlayer && alliance == o.alliance && satuplink == o.satuplink;
+	}
+	bool operator !=(const RadarColourInputs &o) const { return !(*this == o); }
+};
+
+static RadarColourInputs radarColourInputs;	///< Inputs the cached tile colours were computed with.
+static bool radarAllDirty = true;		///< Recolour every tile on the next refresh.
+static std::vector<uint8_t> radarDirtyTiles;	///< Map tiles whose radar colour may have changed, indexed like psMapTiles.
+static int radarDirtyX0 = INT_MAX, radarDirtyY0 = INT_MAX, radarDirtyX1 = 0, radarDirtyY1 = 0;	///< Bounds of the tiles set in radarDirtyTiles.
+static std::vector<UDWORD> radarTileColours;	///< Radar texels without the object overlay.
+static std::vector<uint8_t> radarTexelDirty;	///< Texels whose tile colour changed since radarBitmap was composed.
+static std::vector<UDWORD> radarComposedOverlay;	///< Object overlay currently mixed into radarBitmap.
+
 // taken from https://en.wikipedia.org/wiki/Alpha_compositing
 PIELIGHT inline mix(PIELIGHT over, PIELIGHT base)
 {
@@ -268,6 +301,7 @@ bool resizeRadar()
 	radarBitmap.allocate(radarTexWidth, radarTexHeight, 4, true);
 	radarOverlayBuffer = (uint32_t*)malloc(radarBufferSize);
 	memset(radarOverlayBuffer, 0, radarBufferSize);
+	radarMarkAllDirty();
 	frameSkip = 0;
 	if (rotateRadar)
 	{
@@ -289,6 +323,11 @@ bool ShutdownRadar()
 	radarBitmap.clear();
 	free(radarOverlayBuffer);
 	radarOverlayBuffer = nullptr;
+	radarMarkAllDirty();
+	radarDirtyTiles.clear();
+	radarTileColours.clear();
+	radarTexelDirty.clear();
+	radarComposedOverlay.clear();
 	frameSkip = 0;
 	if (pRadarWidget)
 	{
@@ -376,10 +415,11 @@ void drawRadar()
 
 	if (frameSkip <= 0)
 	{
+		size_t changedX0, changedY0, changedX1, changedY1;
 		DrawRadarTiles();
 		DrawRadarObjects();
-		applyMinimapOverlay();
-		pie_DownLoadRadar(radarBitmap);
+		applyMinimapOverlay(&changedX0, &changedY0, &changedX1, &changedY1);
+		pie_DownLoadRadar(radarBitmap, changedX0, changedY0, changedX1, changedY1);
 		frameSkip = RADAR_FRAME_SKIP;
 	}
 	frameSkip--;
@@ -494,36 +534,117 @@ static PIELIGHT inline appliedRadarColour(RADAR_DRAW_MODE drawMode, MAPTILE *WTi
 	return WScr;
 }
 
-/** Draw the map tiles on the radar. */
+static RadarColourInputs currentRadarColourInputs()
+{
+	RadarColourInputs inputs;
+	inputs.mapTiles = psMapTiles.get();
+	inputs.mapWidth = mapWidth;
+	inputs.mapHeight = mapHeight;
+	inputs.scrollMinX = scrollMinX;
+	inputs.scrollMinY = scrollMinY;
+	inputs.scrollMaxX = scrollMaxX;
+	inputs.scrollMaxY = scrollMaxY;
+	inputs.drawMode = radarDrawMode;
+	inputs.reveal = getRevealStatus();
+	inputs.godMode = godMode;
+	inputs.selectedPlayer = selectedPlayer;
+	inputs.alliance = selectedPlayer < MAX_PLAYER_SLOTS ? alliancebits[selectedPlayer] : 0;
+	inputs.satuplink = satuplinkbits;
+	return inputs;
+}
+
+static UDWORD radarTileColour(int x, int y)
+{
+	if (y == scrollMinY || x == scrollMinX || y == scrollMaxY - 1 || x == scrollMaxX - 1)
+	{
+		return WZCOL_BLACK.rgba;
+	}
+	return appliedRadarColour(radarDrawMode, mapTile(x, y)).rgba;
+}
+
+static void clearRadarDirtyBounds()
+{
+	radarDirtyX0 = radarDirtyY0 = INT_MAX;
+	radarDirtyX1 = radarDirtyY1 = 0;
+}
+
+void radarMarkTileDirty(int x, int y)
+{
+	if (radarAllDirty || x < 0 || y < 0 || x >= radarColourInputs.mapWidth || y >= radarColourInputs.mapHeight)
+	{
+		return;
+	}
+	size_t index = static_cast<size_t>(y) * radarColourInputs.mapWidth + x;
+	ASSERT_OR_RETURN(, index < radarDirtyTiles.size(), "Radar dirty tiles not allocated");
+	radarDirtyTiles[index] = 1;
+	radarDirtyX0 = std::min(radarDirtyX0, x);
+	radarDirtyY0 = std::min(radarDirtyY0, y);
+	radarDirtyX1 = std::max(radarDirtyX1, x + 1);
+	radarDirtyY1 = std::max(radarDirtyY1, y + 1);
+}
+
+void radarMarkAllDirty()
+{
+	radarAllDirty = true;
+}
+
+/** Draw the map tiles on the radar. Only tiles marked dirty since the last call are recoloured, unless something they all depend on changed. */
 static void DrawRadarTiles()
 {
-	SDWORD	x, y;
-	size_t radarBufferSize2 = radarBitmap.size_in_bytes();
-	unsigned char* pRaderBuffer = radarBitmap.bmp_w();
+	const size_t radarTexCount = radarTexWidth * radarTexHeight;
+	const RadarColourInputs inputs = currentRadarColourInputs();
+	if (inputs != radarColourInputs || radarTileColours.size() != radarTexCount)
+	{
+		radarColourInputs = inputs;
+		radarAllDirty = true;
+	}
 
-	for (x = scrollMinX; x < scrollMaxX; x++)
+	if (radarAllDirty)
 	{
-		for (y = scrollMinY; y < scrollMaxY; y++)
+		radarDirtyTiles.assign(static_cast<size_t>(mapWidth) * mapHeight, 0);
+		radarTileColours.assign(radarTexCount, 0);
+		radarTexelDirty.assign(radarTexCount, 1);
+		radarComposedOverlay.assign(radarTexCount, 0);
+		for (int y = scrollMinY; y < scrollMaxY; y++)
 		{
-			MAPTILE	*psTile = mapTile(x, y);
-			size_t pixelStartPos = (radarTexWidth * (y - scrollMinY) + (x - scrollMinX)) * 4;
+			for (int x = scrollMinX; x < scrollMaxX; x++)
+			{
+				size_t pos = radarTexWidth * (y - scrollMinY) + (x - scrollMinX);
+				ASSERT(pos < radarTexCount, "Buffer overrun");
+				radarTileColours[pos] = radarTileColour(x, y);
+			}
+		}
+		clearRadarDirtyBounds();
+		radarAllDirty = false;
+		return;
+	}
 
-			ASSERT(pixelStartPos < radarBufferSize2, "Buffer overrun");
-			if (y == scrollMinY || x == scrollMinX || y == scrollMaxY - 1 || x == scrollMaxX - 1)
+	const int x0 = std::max(radarDirtyX0, scrollMinX);
+	const int x1 = std::min(radarDirtyX1, scrollMaxX);
+	for (int y = radarDirtyY0; y < radarDirtyY1; y++)
+	{
+		uint8_t *dirtyRow = &radarDirtyTiles[static_cast<size_t>(y) * mapWidth];
+		if (y >= scrollMinY && y < scrollMaxY)
+		{
+			for (int x = x0; x < x1; x++)
 			{
-				pRaderBuffer[pixelStartPos] = WZCOL_BLACK.byte.r;
-				pRaderBuffer[pixelStartPos + 1] = WZCOL_BLACK.byte.g;
-				pRaderBuffer[pixelStartPos + 2] = WZCOL_BLACK.byte.b;
-				pRaderBuffer[pixelStartPos + 3] = WZCOL_BLACK.byte.a;
-				continue;
+				if (!dirtyRow[x])
+				{
+					continue;
+				}
+				size_t pos = radarTexWidth * (y - scrollMinY) + (x - scrollMinX);
+				ASSERT(pos < radarTexCount, "Buffer overrun");
+				UDWORD colour = radarTileColour(x, y);
+				if (colour != radarTileColours[pos])
+				{
+					radarTileColours[pos] = colour;
+					radarTexelDirty[pos] = 1;
+				}
 			}
-			auto radarColor = appliedRadarColour(radarDrawMode, psTile);
-			pRaderBuffer[pixelStartPos] = radarColor.byte.r;
-			pRaderBuffer[pixelStartPos + 1] = radarColor.byte.g;
-			pRaderBuffer[pixelStartPos + 2] = radarColor.byte.b;
-			pRaderBuffer[pixelStartPos + 3] = radarColor.byte.a;
 		}
+		std::fill(dirtyRow + radarDirtyX0, dirtyRow + radarDirtyX1, 0);
 	}
+	clearRadarDirtyBounds();
 }
 
 /** Draw the droids and structure positions on the radar. */
@@ -656,25 +777,45 @@ static void DrawRadarObjects()
 		lastBlink = gameTime;
 }
 
-static void applyMinimapOverlay()
+/** Mix the object overlay into the radar tile colours, for the texels where either changed since the last call.
+ *  The changed texels are returned as [x0, x1) x [y0, y1), which is empty if nothing changed. */
+static void applyMinimapOverlay(size_t *changedX0, size_t *changedY0, size_t *changedX1, size_t *changedY1)
 {
 	size_t radarTexCount = radarTexWidth * radarTexHeight;
 	size_t radarBufferSize2 = radarBitmap.size_in_bytes();
 	unsigned char* pRaderBuffer = radarBitmap.bmp_w();
 	ASSERT(radarTexCount * static_cast<size_t>(radarBitmap.channels()) <= radarBufferSize2, "Buffer overrun");
 	ASSERT(radarTexCount * static_cast<size_t>(radarBitmap.channels()) <= radarBufferSize, "Buffer overrun");
-	for (size_t i = 0; i < radarTexCount; i++)
+	ASSERT(radarTexCount <= radarTileColours.size(), "Buffer overrun");
+	*changedX0 = radarTexWidth;
+	*changedY0 = radarTexHeight;
+	*changedX1 = *changedY1 = 0;
+	for (size_t y = 0; y < radarTexHeight; y++)
 	{
-		if (radarOverlayBuffer[i] == 0)
-			continue;
-		size_t pixelStartPos = (i * 4);
-		PIELIGHT baseColor = pal_RGBA(pRaderBuffer[pixelStartPos], pRaderBuffer[pixelStartPos + 1], pRaderBuffer[pixelStartPos + 2], pRaderBuffer[pixelStartPos + 3]);
-		PIELIGHT overColor = PLfromUDWORD(radarOverlayBuffer[i]);
-		PIELIGHT mixedColor = mix(overColor, baseColor);
-		pRaderBuffer[pixelStartPos] = mixedColor.byte.r;
-		pRaderBuffer[pixelStartPos + 1] = mixedColor.byte.g;
-		pRaderBuffer[pixelStartPos + 2] = mixedColor.byte.b;
-		pRaderBuffer[pixelStartPos + 3] = mixedColor.byte.a;
+		for (size_t x = 0; x < radarTexWidth; x++)
+		{
+			size_t i = y * radarTexWidth + x;
+			if (!radarTexelDirty[i] && radarOverlayBuffer[i] == radarComposedOverlay[i])
+			{
+				continue;
+			}
+			radarTexelDirty[i] = 0;
+			radarComposedOverlay[i] = radarOverlayBuffer[i];
+			PIELIGHT color = PLfromUDWORD(radarTileColours[i]);
+			if (radarOverlayBuffer[i] != 0)
+			{
+				color = mix(PLfromUDWORD(radarOverlayBuffer[i]), color);
+			}
+			size_t pixelStartPos = (i * 4);
+			pRaderBuffer[pixelStartPos] = color.byte.r;
+			pRaderBuffer[pixelStartPos + 1] = color.byte.g;
+			pRaderBuffer[pixelStartPos + 2] = color.byte.b;
+			pRaderBuffer[pixelStartPos + 3] = color.byte.a;
+			*changedX0 = std::min(*changedX0, x);
+			*changedY0 = std::min(*changedY0, y);
+			*changedX1 = std::max(*changedX1, x + 1);
+			*changedY1 = std::max(*changedY1, y + 1);
+		}
 	}
 }
 
@@ -823,6 +964,7 @@ void radarColour(UDWORD tileNumber, uint8_t r, uint8_t g, uint8_t b)
 	tileColours[tileNumber].byte.g = g;
 	tileColours[tileNumber].byte.b = b;
 	tileColours[tileNumber].byte.a = 255;
+	radarMarkAllDirty();
 }
 
 
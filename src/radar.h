@@ -41,6 +41,8 @@ bool InitRadar();				///< Initialize minimap subsystem.
 bool ShutdownRadar();			///< Shutdown minimap subsystem.
 bool resizeRadar();				///< Recalculate minimap size. For initialization code only.
 void drawRadar();				///< Draw the minimap on the screen.
+void radarMarkTileDirty(int x, int y);	///< Recolour this tile on the next minimap refresh. Call when its visibility, height or texture changes.
+void radarMarkAllDirty();		///< Recolour every tile on the next minimap refresh.
 void CalcRadarPosition(int mX, int mY, int *PosX, int *PosY);	///< Given a position within the radar, returns a world coordinate.
 void SetRadarZoom(uint8_t ZoomLevel);		///< Set current zoom level. 1.0 is 1:1 resolution.
 uint8_t GetRadarZoom();			///< Get current zoom level.
@@ -65,6 +65,18 @@ SDWORD					CBResFacilityOwner;
 //List of pointers to arrays of PLAYER_RESEARCH[numResearch] for each player
 std::vector<PLAYER_RESEARCH> asPlayerResList[MAX_PLAYERS];
 
+/* Per-player topics that researchAvailable() may return true for, ignoring the structure and facility checks.
+ * Rebuilt on first use after any PLAYER_RESEARCH changes, see researchStatusChanged(). */
+struct ResearchCandidates
+{
+	bool valid = false;
+	uint32_t generation = 0;
+	size_t numResearch = 0;
+	std::vector<uint16_t> topics;
+};
+static uint32_t researchStatusGeneration = 0;
+static std::array<ResearchCandidates, MAX_PLAYERS> researchCandidates;
+
 /* Default level of sensor, Repair and ECM */
 UDWORD					aDefaultSensor[MAX_PLAYERS];
 UDWORD					aDefaultECM[MAX_PLAYERS];
@@ -113,6 +125,7 @@ bool researchInitVars()
 	cachedStatsObject = nlohmann::json(nullptr);
 	cachedPerPlayerUpgrades.clear();
 	playerUpgradeCounts = std::vector<PlayerUpgradeCounts>(MAX_PLAYERS);
+	researchStatusChanged();
 
 	for (int i = 0; i < MAX_PLAYERS; i++)
 	{
@@ -596,6 +609,65 @@ bool loadResearch(WzConfig &ini)
 	return true;
 }
 
+void researchStatusChanged()
+{
+	++researchStatusGeneration;
+}
+
+/// Whether researchAvailable() can return true for the topic, in either mode, given suitable structures.
+static bool researchCandidate(int inc, UDWORD playerID)
+{
+	PLAYER_RESEARCH const *psPlayerRes = &asPlayerResList[playerID][inc];
+	if (IsResearchCancelled(psPlayerRes) || IsResearchCancelledPending(psPlayerRes))
+	{
+		return true;
+	}
+	if (IsResearchDisabled(psPlayerRes) || IsResearchCompleted(psPlayerRes))
+	{
+		return false;
+	}
+	if (IsResearchPossible(psPlayerRes))
+	{
+		return true;
+	}
+	if (asResearch[inc].pPRList.empty())
+	{
+		return false;
+	}
+	for (UWORD prerequisite : asResearch[inc].pPRList)
+	{
+		if (!IsResearchCompleted(&asPlayerResList[playerID][prerequisite]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+const std::vector<uint16_t> &researchCandidateList(UDWORD playerID)
+{
+	static const std::vector<uint16_t> none;
+	ASSERT_OR_RETURN(none, playerID < MAX_PLAYERS, "Invalid player %u", playerID);
+	ASSERT_OR_RETURN(none, asPlayerResList[playerID].size() >= asResearch.size(), "Research list of player %u not initialised", playerID);
+
+	ResearchCandidates &candidates = researchCandidates[playerID];
+	if (!candidates.valid || candidates.generation != researchStatusGeneration || candidates.numResearch != asResearch.size())
+	{
+		candidates.topics.clear();
+		for (int inc = 0; inc < asResearch.size(); inc++)
+		{
+			if (researchCandidate(inc, playerID))
+			{
+				candidates.topics.push_back(inc);
+			}
+		}
+		candidates.valid = true;
+		candidates.generation = researchStatusGeneration;
+		candidates.numResearch = asResearch.size();
+	}
+	return candidates.topics;
+}
+
 bool researchAvailable(int inc, UDWORD playerID, QUEUE_MODE mode)
 {
 	if (playerID >= MAX_PLAYERS)
@@ -719,11 +791,29 @@ There can only be 'limit' number of entries
 std::vector<uint16_t> fillResearchList(UDWORD playerID, nonstd::optional<UWORD> topic, UWORD limit)
 {
 	std::vector<uint16_t> list;
+	if (playerID >= MAX_PLAYERS)
+	{
+		return list;
+	}
 
-	for (auto inc = 0; inc < asResearch.size(); inc++)
+	// if the inc matches the 'topic' - automatically add to the list, keeping the list sorted
+	bool topicPending = topic.has_value() && topic.value() < asResearch.size();
+	for (uint16_t inc : researchCandidateList(playerID))
 	{
-		// if the inc matches the 'topic' - automatically add to the list
-		if ((topic.has_value() && inc == topic.value()) || researchAvailable(inc, playerID, ModeQueue))
+		if (topicPending && topic.value() <= inc)
+		{
+			topicPending = false;
+			list.push_back(topic.value());
+			if (list.size() == limit)
+			{
+				return list;
+			}
+			if (topic.value() == inc)
+			{
+				continue;
+			}
+		}
+		if (researchAvailable(inc, playerID, ModeQueue))
 		{
 			list.push_back(inc);
 			if (list.size() == limit)
@@ -732,6 +822,10 @@ std::vector<uint16_t> fillResearchList(UDWORD playerID, nonstd::optional<UWORD>
 			}
 		}
 	}
+	if (topicPending)
+	{
+		list.push_back(topic.value());
+	}
 
 	return list;
 }
@@ -1194,6 +1288,7 @@ void ResearchRelease()
 	{
 		i.clear();
 	}
+	researchStatusChanged();
 	cachedStatsObject = nlohmann::json(nullptr);
 	cachedPerPlayerUpgrades.clear();
 	for (auto &p : cachedPerPlayerRawUpgradeChange)
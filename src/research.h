@@ -147,6 +147,9 @@ void CancelAllResearch(UDWORD pl);
 bool researchInitVars();
 
 bool researchAvailable(int inc, UDWORD playerID, QUEUE_MODE mode);
+/// The topics, in index order, that researchAvailable() may return true for. Every other topic is unavailable.
+/// Cached until the research status of any player changes.
+const std::vector<uint16_t> &researchCandidateList(UDWORD playerID);
 
 struct AllyResearch
 {
@@ -96,6 +96,9 @@ struct PLAYER_RESEARCH
 #define RESEARCH_POSSIBLE          0x01            // research is possible
 #define RESEARCH_DISABLED          0x02            // research is disabled (e.g. most VTOL research in no-VTOL games)
 
+/// Invalidates the cached research availability (see researchAvailable()). Called by every function below that changes a PLAYER_RESEARCH.
+void researchStatusChanged();
+
 static inline bool IsResearchPossible(const PLAYER_RESEARCH *research)
 {
 	return research->possible == RESEARCH_POSSIBLE;
@@ -111,12 +114,14 @@ static inline void MakeResearchPossible(PLAYER_RESEARCH *research)
 	if (research->possible == RESEARCH_IMPOSSIBLE)
 	{
 		research->possible = RESEARCH_POSSIBLE;
+		researchStatusChanged();
 	}
 }
 
 static inline void DisableResearch(PLAYER_RESEARCH *research)
 {
 	research->possible = RESEARCH_DISABLED;
+	researchStatusChanged();
 }
 
 static inline int GetResearchPossible(const PLAYER_RESEARCH *research)
@@ -127,6 +132,7 @@ static inline int GetResearchPossible(const PLAYER_RESEARCH *research)
 static inline void SetResearchPossible(PLAYER_RESEARCH *research, UBYTE possible)
 {
 	research->possible = possible;
+	researchStatusChanged();
 }
 
 static inline bool IsResearchCompleted(PLAYER_RESEARCH const *x)
@@ -159,37 +165,44 @@ static inline void MakeResearchCompleted(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_ALL;
 	x->ResearchStatus |= RESEARCHED;
+	researchStatusChanged();
 }
 static inline void MakeResearchCancelled(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_ALL;
 	x->ResearchStatus |= CANCELLED_RESEARCH;
+	researchStatusChanged();
 }
 static inline void MakeResearchStarted(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_ALL;
 	x->ResearchStatus |= STARTED_RESEARCH;
+	researchStatusChanged();
 }
 /// Pending means not yet synchronised, so only permitted to affect the UI, not the game state.
 static inline void MakeResearchCancelledPending(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_PENDING_ONLY;
 	x->ResearchStatus |= CANCELLED_RESEARCH_PENDING;
+	researchStatusChanged();
 }
 static inline void MakeResearchStartedPending(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_PENDING_ONLY;
 	x->ResearchStatus |= STARTED_RESEARCH_PENDING;
+	researchStatusChanged();
 }
 static inline void ResetPendingResearchStatus(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_PENDING_ONLY;
+	researchStatusChanged();
 }
 
 /// clear all bits in the status except for the possible bit
 static inline void ResetResearchStatus(PLAYER_RESEARCH *x)
 {
 	x->ResearchStatus &= ~RESBITS_ALL;
+	researchStatusChanged();
 }
 
 void RecursivelyDisableResearchByFlags(UBYTE flags);
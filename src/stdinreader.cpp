@@ -26,6 +26,8 @@
 #include "multistat.h"
 #include "multilobbycommands.h"
 #include "clparse.h"
+#include "telemetry.h"
+#include "profiling.h"
 
 #include <string>
 #include <atomic>
@@ -851,6 +853,57 @@ int cmdInputThreadFunc(void *)
 				});
 			}
 		}
+		else if(!strncmpl(line, "set telemetry "))
+		{
+			char intervalstr[1024] = {0};
+			int r = sscanf(line, "set telemetry %1023s", intervalstr);
+			if (r != 1)
+			{
+				wz_command_interface_output_onmainthread("WZCMD error: Failed to get telemetry interval!\n");
+				continue;
+			}
+			uint32_t intervalMs = 0;
+			if (strcmp(intervalstr, "off") != 0)
+			{
+				char *endptr = nullptr;
+				unsigned long parsedInterval = strtoul(intervalstr, &endptr, 10);
+				if (endptr == intervalstr || *endptr != '\0' || parsedInterval < 100 || parsedInterval > std::numeric_limits<uint32_t>::max())
+				{
+					wz_command_interface_output_onmainthread("WZCMD error: Invalid telemetry interval! (Expecting \"off\" or a number of milliseconds >= 100)\n");
+					continue;
+				}
+				intervalMs = static_cast<uint32_t>(parsedInterval);
+			}
+			wzAsyncExecOnMainThread([intervalMs] {
+				telemetrySetInterval(intervalMs);
+				wz_command_interface_output("WZCMD info: telemetry interval set to: %" PRIu32 "\n", intervalMs);
+			});
+		}
+		else if(!strncmpl(line, "trace dump "))
+		{
+			char filenamestr[1024] = {0};
+			int r = sscanf(line, "trace dump %1023s", filenamestr);
+			if (r != 1)
+			{
+				wz_command_interface_output_onmainthread("WZCMD error: Failed to get trace file name!\n");
+				continue;
+			}
+#if defined(WZ_PROFILING_TRACE)
+			std::string filenameStrCopy(filenamestr);
+			wzAsyncExecOnMainThread([filenameStrCopy] {
+				if (profiling::traceDump(filenameStrCopy.c_str()))
+				{
+					wz_command_interface_output("WZCMD info: trace written to: traces/%s\n", filenameStrCopy.c_str());
+				}
+				else
+				{
+					wz_command_interface_output("WZCMD error: Failed to write trace: %s\n", filenameStrCopy.c_str());
+				}
+			});
+#else
+			wz_command_interface_output_onmainthread("WZCMD error: trace dump is unavailable (not built with WZ_PROFILING_TRACE)\n");
+#endif
+		}
 		else if(!strncmpl(line, "ban ip "))
 		{
 			char tobanip[1024] = {0};
@@ -80,6 +80,7 @@
 #include "gateway.h"
 #include "multistat.h"
 #include "keybind.h"
+#include "radar.h"
 
 #include "random.h"
 #include <functional>
@@ -95,6 +96,10 @@
 //used to calculate how often to increase the resistance level of a structure
 #define RESISTANCE_INTERVAL			2000
 
+// How long an idle defensive structure goes without looking for targets, see structureIsIdle()
+// Skips a single update, so a newly arrived enemy is noticed at most one tick later.
+#define STRUCTURE_IDLE_SLEEP_TIME	(GAME_TICKS_PER_UPDATE * 2)
+
 //Value is stored for easy access to this structure stat
 UDWORD			factoryModuleStat;
 UDWORD			powerModuleStat;
@@ -3728,14 +3733,123 @@ int gateCurrentOpenHeight(const STRUCTURE *psStructure, uint32_t time, int minim
 	return 0;
 }
 
+/* Add smoke to damaged structures. Visual only, so not synchronised. */
+static void structureUpdateSmoke(STRUCTURE *psBuilding)
+{
+	if (!psBuilding->visibleForLocalDisplay() || !canSmoke(psBuilding))
+	{
+		return;
+	}
+
+	const int32_t damage = getStructureDamage(psBuilding);
+
+	// Is there any damage?
+	if (damage > 0.)
+	{
+		UDWORD emissionInterval = static_cast<UDWORD>(CalcStructureSmokeInterval(damage / 65536.f));
+		unsigned effectTime = std::max(gameTime - deltaGameTime + 1, psBuilding->lastEmission + emissionInterval);
+		if (gameTime >= effectTime)
+		{
+			const Vector2i size = psBuilding->size();
+			UDWORD widthScatter   = size.x * TILE_UNITS / 2 / 3;
+			UDWORD breadthScatter = size.y * TILE_UNITS / 2 / 3;
+			Vector3i dv;
+			dv.x = psBuilding->pos.x + widthScatter - rand() % (2 * widthScatter);
+			dv.z = psBuilding->pos.y + breadthScatter - rand() % (2 * breadthScatter);
+			dv.y = psBuilding->pos.z;
+			dv.y += (psBuilding->sDisplay.imd->max.y * 3) / 4;
+			addEffect(&dv, EFFECT_SMOKE, SMOKE_TYPE_DRIFTING_HIGH, false, nullptr, 0, effectTime);
+			psBuilding->lastEmission = effectTime;
+		}
+	}
+}
+
+/* Whether the only thing structureUpdate() would do for the structure is look for a target.
+ * Such structures go to sleep for STRUCTURE_IDLE_SLEEP_TIME, and wake early if this stops being true or if attacked. */
+static bool structureIsIdle(const STRUCTURE *psBuilding)
+{
+	switch (psBuilding->pStructureType->type)
+	{
+	case REF_DEFENSE:
+	case REF_WALL:
+	case REF_WALLCORNER:
+	case REF_GENERIC:
+	case REF_FORTRESS:
+		break;
+	default:
+		return false;  // Gates, factories, research etc. have timers or work to do.
+	}
+
+	if (psBuilding->status != SS_BUILT
+	    || psBuilding->flags.test(OBJECT_FLAG_DIRTY)
+	    || psBuilding->buildRate != 0
+	    || psBuilding->periodicalDamageStart != 0)
+	{
+		return false;
+	}
+
+	if (psBuilding->numWeaps == 0 && (structStandardSensor(psBuilding) || structVTOLSensor(psBuilding) || objRadarDetector(psBuilding)))
+	{
+		return false;  // Sensors keep tracking targets for attached droids.
+	}
+	for (unsigned i = 0; i < MAX_WEAPONS; ++i)
+	{
+		if (psBuilding->psTarget[i] != nullptr)
+		{
+			return false;
+		}
+	}
+	for (unsigned i = 0; i < psBuilding->numWeaps; ++i)
+	{
+		if ((psBuilding->asWeaps[i].rot.direction % DEG(90)) != 0 || psBuilding->asWeaps[i].rot.pitch != 0)
+		{
+			return false;  // Still realigning the turret.
+		}
+	}
+
+	// Resistance and self repair are updated over time.
+	if (psBuilding->resistance < (SWORD)structureResistance(psBuilding->pStructureType, psBuilding->player)
+	    || psBuilding->lastResistance != ACTION_START_TIME)
+	{
+		return false;
+	}
+	if (selfRepairEnabled(psBuilding->player) && psBuilding->body < psBuilding->structureBody())
+	{
+		return false;
+	}
+	return true;
+}
+
+/* Whether the structure is asleep, and can skip its update this tick. */
+static bool structureIsAsleep(const STRUCTURE *psBuilding)
+{
+	if (psBuilding->sleepUntil == 0 || gameTime >= psBuilding->sleepUntil)
+	{
+		return false;
+	}
+	if (psBuilding->timeLastHit != UDWORD_MAX && psBuilding->timeLastHit + STRUCTURE_IDLE_SLEEP_TIME >= psBuilding->sleepUntil)
+	{
+		return false;  // Attacked since going to sleep.
+	}
+	return structureIsIdle(psBuilding);
+}
+
 /* The main update routine for all Structures */
 void structureUpdate(STRUCTURE *psBuilding, bool bMission)
 {
-	UDWORD widthScatter, breadthScatter;
-	UDWORD emissionInterval, iPointsToAdd, iPointsRequired;
-	Vector3i dv;
+	UDWORD iPointsToAdd, iPointsRequired;
 	int i;
 
+	if (!bMission)
+	{
+		if (structureIsAsleep(psBuilding))
+		{
+			structureUpdateSmoke(psBuilding);
+			return;
+		}
+		psBuilding->sleepUntil = 0;
+	}
+
 	syncDebugStructure(psBuilding, '<');
 
 	if (psBuilding->flags.test(OBJECT_FLAG_DIRTY) && !bMission)
@@ -3848,28 +3962,9 @@ void structureUpdate(STRUCTURE *psBuilding, bool bMission)
 	}
 
 	/* Only add smoke if they're visible and they can 'burn' */
-	if (!bMission && psBuilding->visibleForLocalDisplay() && canSmoke(psBuilding))
+	if (!bMission)
 	{
-		const int32_t damage = getStructureDamage(psBuilding);
-
-		// Is there any damage?
-		if (damage > 0.)
-		{
-			emissionInterval = static_cast<UDWORD>(CalcStructureSmokeInterval(damage / 65536.f));
-			unsigned effectTime = std::max(gameTime - deltaGameTime + 1, psBuilding->lastEmission + emissionInterval);
-			if (gameTime >= effectTime)
-			{
-				const Vector2i size = psBuilding->size();
-				widthScatter   = size.x * TILE_UNITS / 2 / 3;
-				breadthScatter = size.y * TILE_UNITS / 2 / 3;
-				dv.x = psBuilding->pos.x + widthScatter - rand() % (2 * widthScatter);
-				dv.z = psBuilding->pos.y + breadthScatter - rand() % (2 * breadthScatter);
-				dv.y = psBuilding->pos.z;
-				dv.y += (psBuilding->sDisplay.imd->max.y * 3) / 4;
-				addEffect(&dv, EFFECT_SMOKE, SMOKE_TYPE_DRIFTING_HIGH, false, nullptr, 0, effectTime);
-				psBuilding->lastEmission = effectTime;
-			}
-		}
+		structureUpdateSmoke(psBuilding);
 	}
 
 	/* Update the fire damage data */
@@ -3965,6 +4060,11 @@ void structureUpdate(STRUCTURE *psBuilding, bool bMission)
 		}
 	}
 
+	if (!bMission && structureIsIdle(psBuilding))
+	{
+		psBuilding->sleepUntil = gameTime + STRUCTURE_IDLE_SLEEP_TIME;
+	}
+
 	syncDebugStructure(psBuilding, '>');
 
 	CHECK_STRUCTURE(psBuilding);
@@ -4852,7 +4952,7 @@ bool checkSpecificStructExists(UDWORD structInc, UDWORD player)
 {
 	ASSERT_OR_RETURN(false, structInc < numStructureStats, "Invalid structure inc");
 
-	for (const STRUCTURE *psStructure : apsStructLists[player])
+	for (const STRUCTURE *psStructure : structuresOfType(player, asStructureStats[structInc].type))
 	{
 		if (psStructure->status == SS_BUILT)
 		{
@@ -6024,6 +6124,7 @@ void hqReward(UBYTE losingPlayer, UBYTE rewardPlayer)
 			}
 		}
 	}
+	radarMarkAllDirty();
 
 	//struct
 	for (int i = 0; i < MAX_PLAYERS; ++i)
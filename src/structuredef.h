@@ -313,6 +313,7 @@ struct STRUCTURE : public BASE_OBJECT
 	uint8_t capacity;                ///< Lame name: current number of module upgrades (*not* maximum nb of upgrades)
 	STRUCT_ANIM_STATES	state;
 	UDWORD lastStateTime;
+	uint32_t sleepUntil = 0;         ///< Idle structures skip structureUpdate() until this time, unless woken earlier. 0 if awake.
 	iIMDBaseShape *prebuiltImd;
 	UBYTE productToGroup = UBYTE_MAX;
 
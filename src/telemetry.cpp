@@ -0,0 +1,151 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2024  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#include "telemetry.h"
+
+#include "lib/framework/frame.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/netplay/netplay.h"
+#include "lib/netplay/nettypes.h"
+
+#include "multiplay.h"
+#include "fpath.h"
+#include "stdinreader.h"
+
+#include <algorithm>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Bounds the memory used if the interval is very long (or the game is fast-forwarding).
+#define TELEMETRY_MAX_TICK_SAMPLES 4096
+
+static uint32_t telemetryInterval = 0;
+static uint32_t lastTelemetryTime = 0;
+static std::vector<uint64_t> tickSamples;
+static uint64_t tickSamplesDropped = 0;
+
+void telemetrySetInterval(uint32_t intervalMs)
+{
+	telemetryInterval = intervalMs;
+	lastTelemetryTime = realTime;
+	telemetryReset();
+}
+
+uint32_t telemetryGetInterval()
+{
+	return telemetryInterval;
+}
+
+void telemetryReset()
+{
+	tickSamples.clear();
+	tickSamplesDropped = 0;
+}
+
+void telemetryRecordGameTick(uint64_t durationMicroseconds)
+{
+	if (telemetryInterval == 0)
+	{
+		return;
+	}
+	if (tickSamples.size() >= TELEMETRY_MAX_TICK_SAMPLES)
+	{
+		++tickSamplesDropped;
+		return;
+	}
+	tickSamples.push_back(durationMicroseconds);
+}
+
+/// Nearest-rank percentile. Partially sorts samples.
+static uint64_t samplePercentile(std::vector<uint64_t> &samples, unsigned percentile)
+{
+	if (samples.empty())
+	{
+		return 0;
+	}
+	size_t rank = (samples.size() * percentile + 99) / 100;
+	size_t idx = std::min(std::max<size_t>(rank, 1), samples.size()) - 1;
+	std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+	return samples[idx];
+}
+
+static nlohmann::ordered_json telemetryPlayerReport(uint32_t player)
+{
+	nlohmann::ordered_json j = nlohmann::ordered_json::object();
+	j["index"] = player;
+	j["spectator"] = NetPlay.players[player].isSpectator;
+	j["rtt"] = ingame.PingTimes[player];
+	j["wantedLatency"] = gtimeGetWantedLatency(player);
+	j["queueLead"] = gtimeGetPlayerQueueLead(player);
+	j["gameQueue"] = NETgetPendingGameTimeUpdates(player);
+	j["recvBuffered"] = NETincompleteMessageDataBuffered(NETnetQueue(player));
+	j["bytesIn"] = NETgetPlayerStatistic(player, NetStatisticRawBytes, false);
+	j["bytesOut"] = NETgetPlayerStatistic(player, NetStatisticRawBytes, true);
+	j["packetsIn"] = NETgetPlayerStatistic(player, NetStatisticPackets, false);
+	j["packetsOut"] = NETgetPlayerStatistic(player, NetStatisticPackets, true);
+	return j;
+}
+
+void telemetryUpdate()
+{
+	if (telemetryInterval == 0 || !wz_command_interface_enabled())
+	{
+		return;
+	}
+	if (realTime - lastTelemetryTime < telemetryInterval)
+	{
+		return;
+	}
+	lastTelemetryTime = realTime;
+
+	nlohmann::ordered_json ticks = nlohmann::ordered_json::object();
+	ticks["count"] = tickSamples.size() + tickSamplesDropped;
+	ticks["p50"] = samplePercentile(tickSamples, 50);
+	ticks["p90"] = samplePercentile(tickSamples, 90);
+	ticks["p99"] = samplePercentile(tickSamples, 99);
+	ticks["max"] = tickSamples.empty() ? 0 : *std::max_element(tickSamples.begin(), tickSamples.end());
+	telemetryReset();
+
+	nlohmann::ordered_json report = nlohmann::ordered_json::object();
+	report["realTime"] = realTime;
+	report["gameTime"] = gameTime;
+	report["isHost"] = NetPlay.isHost;
+	report["latency"] = gtimeGetChosenLatency();
+	report["tickUs"] = std::move(ticks);
+	report["pathJobs"] = fpathJobQueueLength();
+	report["bytesIn"] = NETgetStatistic(NetStatisticRawBytes, false, true);
+	report["bytesOut"] = NETgetStatistic(NetStatisticRawBytes, true, true);
+
+	nlohmann::ordered_json players = nlohmann::ordered_json::array();
+	if (NetPlay.bComms)
+	{
+		for (uint32_t player = 0; player < MAX_CONNECTED_PLAYERS; ++player)
+		{
+			if (!isHumanPlayer(player) || player == selectedPlayer)
+			{
+				continue;
+			}
+			players.push_back(telemetryPlayerReport(player));
+		}
+	}
+	report["players"] = std::move(players);
+
+	std::string line = std::string("WZTELEMETRY: ") + report.dump(-1, ' ', false, nlohmann::ordered_json::error_handler_t::replace) + "\n";
+	wz_command_interface_output_str(line.c_str());
+}
@@ -0,0 +1,37 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2024  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/// Periodic host telemetry, written as JSON lines to the command interface (see doc/CmdInterface.md).
+
+/// Sets the interval (in ms of real time) between telemetry reports. 0 disables telemetry.
+void telemetrySetInterval(uint32_t intervalMs);
+uint32_t telemetryGetInterval();
+
+/// Records the wall-clock duration of a single game state update (gameStateUpdate).
+void telemetryRecordGameTick(uint64_t durationMicroseconds);
+
+/// Emits a telemetry report, if enabled and the interval has elapsed. Call once per main loop iteration.
+void telemetryUpdate();
+
+/// Clears any collected samples (e.g. at game start / end).
+void telemetryReset();
@@ -61,10 +61,14 @@
 #include "loop.h"
 #include "wzcrashhandlingproviders.h"
 #include "lighting.h"
+#include "radar.h"
 
 #include "profiling.h"
 
 #include <cstdint>
+#include <atomic>
+#include <functional>
+#include <thread>
 
 // TODO: Fix and remove after merging terrain rendering changes
 #if defined(__clang__)
@@ -159,7 +163,36 @@ static int xSectors, ySectors;
 /// Did we initialise the terrain renderer yet?
 static bool terrainInitialised = false;
 
-static std::vector<gfx_api::TerrainDecalVertex> terrainDecalVertexUpdateBuffer;
+/// Most threads (besides the main thread) used to build sector geometry
+static const unsigned TERRAIN_MAX_THREADS = 4;
+/// Fewer dirty sectors than this are rebuilt on the main thread alone
+static const size_t TERRAIN_PARALLEL_MIN_SECTORS = 2;
+
+/// Threads that help the main thread fill sector geometry, see terrainParallelFor()
+struct TerrainWorkers
+{
+	std::vector<WZ_THREAD *> threads;
+	WZ_SEMAPHORE *startSemaphore = nullptr;
+	WZ_SEMAPHORE *doneSemaphore = nullptr;
+	bool quit = false;
+	size_t numJobs = 0;
+	const std::function<void (size_t)> *job = nullptr;
+	std::atomic<size_t> nextJob{0};
+};
+static TerrainWorkers terrainWorkers;
+
+/// Scratch buffers for rebuilding dirty sectors, kept between rebuilds so bursts of terrain changes don't allocate
+struct SectorRebuildArena
+{
+	std::vector<int> sectorIndices;
+	std::vector<size_t> geometryStart, waterStart, decalStart, terrainDecalStart;
+	std::vector<int> geometryFilled, waterFilled, decalFilled, terrainDecalFilled;
+	std::vector<TerrainVertex> geometry;
+	std::vector<WaterVertex> water;
+	std::vector<DecalVertex> decals;
+	std::vector<gfx_api::TerrainDecalVertex> terrainDecals;
+};
+static SectorRebuildArena sectorRebuildArena;
 
 /// Helper to specify the offset in a VBO
 #define BUFFER_OFFSET(i) (reinterpret_cast<char *>(i))
@@ -662,53 +695,211 @@ static void setSectorDecalVertex_SinglePass(int x, int y, gfx_api::TerrainDecalV
 	}
 }
 
+/// The number of vertices setSectorDecals() or setSectorDecalVertex_SinglePass() will produce for a sector
+static int sectorDecalVertexCount(int x, int y)
+{
+	int count = 0;
+	for (int i = x * sectorSize; i < std::min(x * sectorSize + sectorSize, mapWidth); i++)
+	{
+		for (int j = y * sectorSize; j < std::min(y * sectorSize + sectorSize, mapHeight); j++)
+		{
+			if (terrainShaderType == TerrainShaderType::SINGLE_PASS || TILE_HAS_DECAL(mapTile(i, j)))
+			{
+				count += 12;
+			}
+		}
+	}
+	return count;
+}
+
+static void runTerrainJobs()
+{
+	for (size_t i = terrainWorkers.nextJob++; i < terrainWorkers.numJobs; i = terrainWorkers.nextJob++)
+	{
+		(*terrainWorkers.job)(i);
+	}
+}
+
+static int terrainWorkerThreadFunc(void *)
+{
+	for (;;)
+	{
+		wzSemaphoreWait(terrainWorkers.startSemaphore);
+		if (terrainWorkers.quit)
+		{
+			break;
+		}
+		runTerrainJobs();
+		wzSemaphorePost(terrainWorkers.doneSemaphore);
+	}
+	return 0;
+}
+
+static void startTerrainWorkers()
+{
+	if (!terrainWorkers.threads.empty())
+	{
+		return;
+	}
+	unsigned numThreads = std::min(TERRAIN_MAX_THREADS, std::max(std::thread::hardware_concurrency(), 1u) - 1);
+	if (numThreads == 0)
+	{
+		return;
+	}
+	terrainWorkers.quit = false;
+	terrainWorkers.startSemaphore = wzSemaphoreCreate(0);
+	terrainWorkers.doneSemaphore = wzSemaphoreCreate(0);
+	for (unsigned i = 0; i < numThreads; ++i)
+	{
+		WZ_THREAD *thread = wzThreadCreate(terrainWorkerThreadFunc, nullptr, "wzTerrain");
+		wzThreadStart(thread);
+		terrainWorkers.threads.push_back(thread);
+	}
+	debug(LOG_TERRAIN, "Using %u worker threads for terrain geometry", numThreads);
+}
+
+static void stopTerrainWorkers()
+{
+	if (terrainWorkers.threads.empty())
+	{
+		return;
+	}
+	terrainWorkers.quit = true;
+	for (size_t i = 0; i < terrainWorkers.threads.size(); ++i)
+	{
+		wzSemaphorePost(terrainWorkers.startSemaphore);
+	}
+	for (WZ_THREAD *thread : terrainWorkers.threads)
+	{
+		wzThreadJoin(thread);
+	}
+	terrainWorkers.threads.clear();
+	wzSemaphoreDestroy(terrainWorkers.startSemaphore);
+	wzSemaphoreDestroy(terrainWorkers.doneSemaphore);
+	terrainWorkers.startSemaphore = nullptr;
+	terrainWorkers.doneSemaphore = nullptr;
+}
+
 /**
- * Update the sector for when the terrain is changed.
+ * Call job(0) ... job(numJobs - 1), spread over the main thread and the terrain workers, and wait for all of them.
+ * Jobs may only read the map, and must write to disjoint memory.
  */
-static void updateSectorGeometry(int x, int y)
+static void terrainParallelFor(size_t numJobs, const std::function<void (size_t)> &job)
 {
-	TerrainVertex *geometry;
-	WaterVertex *water;
-	DecalVertex *decaldata;
-	int geometrySize = 0;
-	int waterSize = 0;
-	int decalSize = 0;
-
-	geometry = new TerrainVertex[sectors[x * ySectors + y].geometrySize];
-	water = (WaterVertex *)malloc(sizeof(WaterVertex) * sectors[x * ySectors + y].waterSize);
+	if (terrainWorkers.threads.empty() || numJobs < TERRAIN_PARALLEL_MIN_SECTORS)
+	{
+		for (size_t i = 0; i < numJobs; ++i)
+		{
+			job(i);
+		}
+		return;
+	}
+	terrainWorkers.numJobs = numJobs;
+	terrainWorkers.job = &job;
+	terrainWorkers.nextJob = 0;
+	for (size_t i = 0; i < terrainWorkers.threads.size(); ++i)
+	{
+		wzSemaphorePost(terrainWorkers.startSemaphore);
+	}
+	runTerrainJobs();
+	for (size_t i = 0; i < terrainWorkers.threads.size(); ++i)
+	{
+		wzSemaphoreWait(terrainWorkers.doneSemaphore);
+	}
+	terrainWorkers.job = nullptr;
+	terrainWorkers.numJobs = 0;
+}
 
-	setSectorGeometry(x, y, geometry, water, &geometrySize, &waterSize);
-	ASSERT(geometrySize == sectors[x * ySectors + y].geometrySize, "something went seriously wrong updating the terrain");
-	ASSERT(waterSize    == sectors[x * ySectors + y].waterSize   , "something went seriously wrong updating the terrain");
+/// Reserve room for each of a list of sectors in an arena buffer, returning the total
+static size_t layoutSectorScratch(const std::vector<int> &sectorIndices, int Sector::*size, std::vector<size_t> &start)
+{
+	size_t total = 0;
+	start.resize(sectorIndices.size());
+	for (size_t i = 0; i < sectorIndices.size(); ++i)
+	{
+		start[i] = total;
+		total += std::max(sectors[sectorIndices[i]].*size, 0);
+	}
+	return total;
+}
 
-	geometryVBO->update(sizeof(TerrainVertex)*sectors[x * ySectors + y].geometryOffset,
-							sizeof(TerrainVertex)*sectors[x * ySectors + y].geometrySize, geometry,
-							gfx_api::buffer::update_flag::non_overlapping_updates_promise);
-	waterVBO->update(sizeof(WaterVertex)*sectors[x * ySectors + y].waterOffset,
-					 sizeof(WaterVertex)*sectors[x * ySectors + y].waterSize, water,
-					 gfx_api::buffer::update_flag::non_overlapping_updates_promise);
+template <typename T>
+static void growScratch(std::vector<T> &buffer, size_t size)
+{
+	if (buffer.size() < size)
+	{
+		buffer.resize(size);
+	}
+}
 
-	delete[] geometry;
-	free(water);
+/**
+ * Update the sectors for when the terrain is changed.
+ * The geometry is filled in parallel into reused scratch buffers, then uploaded from the main thread.
+ */
+static void updateSectorGeometry(const std::vector<int> &sectorIndices)
+{
+	SectorRebuildArena &arena = sectorRebuildArena;
+	const size_t numSectors = sectorIndices.size();
+	const bool fallback = terrainShaderType == TerrainShaderType::FALLBACK;
 
-	if (terrainShaderType == TerrainShaderType::FALLBACK)
+	growScratch(arena.geometry, layoutSectorScratch(sectorIndices, &Sector::geometrySize, arena.geometryStart));
+	growScratch(arena.water, layoutSectorScratch(sectorIndices, &Sector::waterSize, arena.waterStart));
+	if (fallback)
+	{
+		growScratch(arena.decals, layoutSectorScratch(sectorIndices, &Sector::decalSize, arena.decalStart));
+	}
+	else
 	{
-		if (sectors[x * ySectors + y].decalSize <= 0)
+		growScratch(arena.terrainDecals, layoutSectorScratch(sectorIndices, &Sector::terrainAndDecalSize, arena.terrainDecalStart));
+	}
+	arena.geometryFilled.assign(numSectors, 0);
+	arena.waterFilled.assign(numSectors, 0);
+	arena.decalFilled.assign(numSectors, 0);
+	arena.terrainDecalFilled.assign(numSectors, 0);
+
+	terrainParallelFor(numSectors, [&](size_t i) {
+		const int x = sectorIndices[i] / ySectors;
+		const int y = sectorIndices[i] % ySectors;
+		const Sector &sector = sectors[sectorIndices[i]];
+		setSectorGeometry(x, y, arena.geometry.data() + arena.geometryStart[i], arena.water.data() + arena.waterStart[i], &arena.geometryFilled[i], &arena.waterFilled[i]);
+		if (fallback)
 		{
-			// Nothing to do here, and glBufferSubData(GL_ARRAY_BUFFER, 0, 0, *) crashes in my graphics driver. Probably shouldn't crash...
-			return;
+			if (sector.decalSize > 0)
+			{
+				setSectorDecals(x, y, arena.decals.data() + arena.decalStart[i], &arena.decalFilled[i]);
+			}
 		}
+		else
+		{
+			setSectorDecalVertex_SinglePass(x, y, arena.terrainDecals.data() + arena.terrainDecalStart[i], &arena.terrainDecalFilled[i]);
+		}
+	});
 
-		decaldata = (DecalVertex *)malloc(sizeof(DecalVertex) * sectors[x * ySectors + y].decalSize);
-		setSectorDecals(x, y, decaldata, &decalSize);
-		ASSERT(decalSize == sectors[x * ySectors + y].decalSize   , "the amount of decals has changed");
+	for (size_t i = 0; i < numSectors; ++i)
+	{
+		const Sector &sector = sectors[sectorIndices[i]];
+		ASSERT(arena.geometryFilled[i] == sector.geometrySize, "something went seriously wrong updating the terrain");
+		ASSERT(arena.waterFilled[i] == sector.waterSize, "something went seriously wrong updating the terrain");
 
-		if (decalSize > 0)
+		geometryVBO->update(sizeof(TerrainVertex) * sector.geometryOffset,
+							sizeof(TerrainVertex) * sector.geometrySize, arena.geometry.data() + arena.geometryStart[i],
+							gfx_api::buffer::update_flag::non_overlapping_updates_promise);
+		waterVBO->update(sizeof(WaterVertex) * sector.waterOffset,
+						 sizeof(WaterVertex) * sector.waterSize, arena.water.data() + arena.waterStart[i],
+						 gfx_api::buffer::update_flag::non_overlapping_updates_promise);
+
+		if (fallback)
 		{
+			if (sector.decalSize <= 0)
+			{
+				// Nothing to do here, and glBufferSubData(GL_ARRAY_BUFFER, 0, 0, *) crashes in my graphics driver. Probably shouldn't crash...
+				continue;
+			}
+			ASSERT(arena.decalFilled[i] == sector.decalSize, "the amount of decals has changed");
 			if (decalVBO)
 			{
-				decalVBO->update(sizeof(DecalVertex)*sectors[x * ySectors + y].decalOffset,
-								 sizeof(DecalVertex)*sectors[x * ySectors + y].decalSize, decaldata,
+				decalVBO->update(sizeof(DecalVertex) * sector.decalOffset,
+								 sizeof(DecalVertex) * sector.decalSize, arena.decals.data() + arena.decalStart[i],
 								 gfx_api::buffer::update_flag::non_overlapping_updates_promise);
 			}
 			else
@@ -718,18 +909,17 @@ static void updateSectorGeometry(int x, int y)
 				ASSERT(false, "Didn't have decals, but now we do. Unsupported.");
 			}
 		}
-
-		free(decaldata);
-	}
-	else
-	{
-		terrainDecalVertexUpdateBuffer.resize(sectors[x * ySectors + y].terrainAndDecalSize); // reuse a buffer to avoid repeated allocations if possible
-		int terrainDecalSize = 0;
-		setSectorDecalVertex_SinglePass(x, y, terrainDecalVertexUpdateBuffer.data(), &terrainDecalSize);
-		ASSERT(terrainDecalSize == sectors[x * ySectors + y].terrainAndDecalSize, "Sizes don't match!");
-		terrainDecalVBO->update(sizeof(gfx_api::TerrainDecalVertex)*sectors[x * ySectors + y].terrainAndDecalOffset,
-							 sizeof(gfx_api::TerrainDecalVertex)*sectors[x * ySectors + y].terrainAndDecalSize, terrainDecalVertexUpdateBuffer.data(),
-							 gfx_api::buffer::update_flag::non_overlapping_updates_promise);
+		else
+		{
+			ASSERT(arena.terrainDecalFilled[i] == sector.terrainAndDecalSize, "Sizes don't match!");
+			if (sector.terrainAndDecalSize <= 0)
+			{
+				continue;
+			}
+			terrainDecalVBO->update(sizeof(gfx_api::TerrainDecalVertex) * sector.terrainAndDecalOffset,
+								 sizeof(gfx_api::TerrainDecalVertex) * sector.terrainAndDecalSize, arena.terrainDecals.data() + arena.terrainDecalStart[i],
+								 gfx_api::buffer::update_flag::non_overlapping_updates_promise);
+		}
 	}
 }
 
@@ -741,6 +931,8 @@ void markTileDirty(int i, int j)
 {
 	int x, y;
 
+	radarMarkTileDirty(i, j);
+
 	if (!terrainInitialised)
 	{
 		return; // will be updated anyway
@@ -1203,21 +1395,31 @@ bool initTerrain()
 	waterIndex = (GLuint *)malloc(sizeof(GLuint) * xSectors * ySectors * sectorSize * sectorSize * 12);
 	waterSize = 0;
 	waterIndexSize = 0;
+
+	// every sector has the same number of vertices, so they can all be filled at once
+	startTerrainWorkers();
+	const int sectorVertSize = (sectorSize + 1) * (sectorSize + 1) * 2;
+	for (i = 0; i < xSectors * ySectors; i++)
+	{
+		sectors[i].dirty = false;
+		sectors[i].geometryOffset = i * sectorVertSize;
+		sectors[i].geometrySize = sectorVertSize;
+		sectors[i].waterOffset = i * sectorVertSize;
+		sectors[i].waterSize = sectorVertSize;
+	}
+	terrainParallelFor(xSectors * ySectors, [&](size_t sector) {
+		int sectorGeometrySize = 0, sectorWaterSize = 0;
+		setSectorGeometry(sector / ySectors, sector % ySectors, geometry + sectors[sector].geometryOffset, water + sectors[sector].waterOffset, &sectorGeometrySize, &sectorWaterSize);
+		ASSERT(sectorGeometrySize == sectorVertSize && sectorWaterSize == sectorVertSize, "Unexpected sector size");
+	});
+	geometrySize = vertSize;
+	waterSize = vertSize;
+
 	for (x = 0; x < xSectors; x++)
 	{
 		for (y = 0; y < ySectors; y++)
 		{
-			sectors[x * ySectors + y].dirty = false;
-			sectors[x * ySectors + y].geometryOffset = geometrySize;
-			sectors[x * ySectors + y].geometrySize = 0;
-			sectors[x * ySectors + y].waterOffset = waterSize;
-			sectors[x * ySectors + y].waterSize = 0;
-
-			setSectorGeometry(x, y, geometry, water, &geometrySize, &waterSize);
-
-			sectors[x * ySectors + y].geometrySize = geometrySize - sectors[x * ySectors + y].geometryOffset;
-			sectors[x * ySectors + y].waterSize = waterSize - sectors[x * ySectors + y].waterOffset;
-			// and do the index buffers
+			// do the index buffers
 			sectors[x * ySectors + y].geometryIndexOffset = geometryIndexSize;
 			sectors[x * ySectors + y].geometryIndexSize = 0;
 			sectors[x * ySectors + y].waterIndexOffset = waterIndexSize;
@@ -1449,27 +1651,42 @@ bool initTerrain()
 		break;
 	}
 
+	// count the vertices of each sector first, so the sectors can then be filled in parallel
 	for (x = 0; x < xSectors; x++)
 	{
 		for (y = 0; y < ySectors; y++)
 		{
+			const int sectorDecalSize = sectorDecalVertexCount(x, y);
 			switch (terrainShaderType)
 			{
 			case TerrainShaderType::FALLBACK:
 				sectors[x * ySectors + y].decalOffset = decalSize;
-				sectors[x * ySectors + y].decalSize = 0;
-				setSectorDecals(x, y, decaldata, &decalSize);
-				sectors[x * ySectors + y].decalSize = decalSize - sectors[x * ySectors + y].decalOffset;
+				sectors[x * ySectors + y].decalSize = sectorDecalSize;
+				decalSize += sectorDecalSize;
 				break;
 			case TerrainShaderType::SINGLE_PASS:
 				sectors[x * ySectors + y].terrainAndDecalOffset = terrainDecalSize;
-				sectors[x * ySectors + y].terrainAndDecalSize = 0;
-				setSectorDecalVertex_SinglePass(x, y, terrainDecalData, &terrainDecalSize);
-				sectors[x * ySectors + y].terrainAndDecalSize = terrainDecalSize - sectors[x * ySectors + y].terrainAndDecalOffset;
+				sectors[x * ySectors + y].terrainAndDecalSize = sectorDecalSize;
+				terrainDecalSize += sectorDecalSize;
 				break;
 			}
 		}
 	}
+	terrainParallelFor(xSectors * ySectors, [&](size_t sector) {
+		const Sector &psSector = sectors[sector];
+		int filled = 0;
+		switch (terrainShaderType)
+		{
+		case TerrainShaderType::FALLBACK:
+			setSectorDecals(sector / ySectors, sector % ySectors, decaldata + psSector.decalOffset, &filled);
+			ASSERT(filled == psSector.decalSize, "Decal count mismatch");
+			break;
+		case TerrainShaderType::SINGLE_PASS:
+			setSectorDecalVertex_SinglePass(sector / ySectors, sector % ySectors, terrainDecalData + psSector.terrainAndDecalOffset, &filled);
+			ASSERT(filled == psSector.terrainAndDecalSize, "Decal count mismatch");
+			break;
+		}
+	});
 	debug(LOG_TERRAIN, "%i decals found", decalSize / 12);
 	if (decalVBO)
 		delete decalVBO;
@@ -1567,6 +1784,9 @@ void shutdownTerrain()
 	delete terrainDecalVBO;
 	terrainDecalVBO = nullptr;
 
+	stopTerrainWorkers();
+	sectorRebuildArena = SectorRebuildArena();
+
 	for (int x = 0; x < xSectors; x++)
 	{
 		for (int y = 0; y < ySectors; y++)
@@ -1680,6 +1900,8 @@ static void updateLightMap(const LightMap& lightmap)
 
 static void cullTerrain()
 {
+	std::vector<int> &dirtySectors = sectorRebuildArena.sectorIndices;
+	dirtySectors.clear();
 	for (int x = 0; x < xSectors; x++)
 	{
 		for (int y = 0; y < ySectors; y++)
@@ -1697,12 +1919,16 @@ static void cullTerrain()
 				sectors[x * ySectors + y].draw = true;
 				if (sectors[x * ySectors + y].dirty)
 				{
-					updateSectorGeometry(x, y);
+					dirtySectors.push_back(x * ySectors + y);
 					sectors[x * ySectors + y].dirty = false;
 				}
 			}
 		}
 	}
+	if (!dirtySectors.empty())
+	{
+		updateSectorGeometry(dirtySectors);
+	}
 }
 
 static void drawDepthOnly(const glm::mat4 &ModelViewProjection, const glm::vec4 &paramsXLight, const glm::vec4 &paramsYLight, bool withOffset)
@@ -48,6 +48,7 @@
 #include "multiplay.h"
 #include "qtscript.h"
 #include "wavecast.h"
+#include "radar.h"
 #include "profiling.h"
 
 // accuracy for the height gradient
@@ -117,8 +118,9 @@ void visUpdateLevel()
 	visLevelDec = gameTimeAdjustedAverage(VIS_LEVEL_DEC);
 }
 
-static inline void updateTileVis(MAPTILE *psTile)
+static inline void updateTileVis(MAPTILE *psTile, int x, int y)
 {
+	const PlayerMask oldSensorBits = psTile->sensorBits;
 	for (int i = 0; i < MAX_PLAYERS; i++)
 	{
 		/// The definition of whether a player can see something on a given tile or not
@@ -131,6 +133,19 @@ static inline void updateTileVis(MAPTILE *psTile)
 			psTile->sensorBits &= ~(1 << i);        // mark as hidden
 		}
 	}
+	if (psTile->sensorBits != oldSensorBits)
+	{
+		radarMarkTileDirty(x, y);
+	}
+}
+
+static inline void exploreTile(MAPTILE *psTile, int x, int y, PlayerMask explorers)
+{
+	if ((psTile->tileExploredBits & explorers) != explorers)
+	{
+		psTile->tileExploredBits |= explorers;
+		radarMarkTileDirty(x, y);
+	}
 }
 
 uint32_t addSpotter(int x, int y, int player, int radius, bool radar, uint32_t expiry)
@@ -149,13 +164,13 @@ uint32_t addSpotter(int x, int y, int player, int radius, bool radar, uint32_t e
 			continue;
 		}
 		MAPTILE *psTile = mapTile(mapX, mapY);
-		psTile->tileExploredBits |= alliancebits[player];
+		exploreTile(psTile, mapX, mapY, alliancebits[player]);
 		uint8_t *visionType = (!radar) ? psTile->watchers : psTile->sensors;
 		if (visionType[player] < UBYTE_MAX)
 		{
 			TILEPOS tilePos = {uint8_t(mapX), uint8_t(mapY), uint8_t(radar)};
 			visionType[player]++;          // we observe this tile
-			updateTileVis(psTile);
+			updateTileVis(psTile, mapX, mapY);
 			psSpot->watchedTiles[psSpot->numWatchedTiles++] = tilePos;    // record having seen it
 		}
 	}
@@ -221,7 +236,7 @@ SPOTTER::~SPOTTER()
 		uint8_t *visionType = (tilePos.type == 0) ? psTile->watchers : psTile->sensors;
 		ASSERT(visionType[player] > 0, "Not watching watched tile (%d, %d)", (int)tilePos.x, (int)tilePos.y);
 		visionType[player]--;
-		updateTileVis(psTile);
+		updateTileVis(psTile, tilePos.x, tilePos.y);
 	}
 	free(watchedTiles);
 }
@@ -248,7 +263,7 @@ static inline void visMarkTile(const BASE_OBJECT *psObj, int mapX, int mapY, MAP
 			psTile->jammers[rayPlayer]++;
 			psTile->jammerBits |= (1 << rayPlayer); // mark it as being jammed
 		}
-		updateTileVis(psTile);
+		updateTileVis(psTile, mapX, mapY);
 		watchedTiles.push_back(tilePos);  // record having seen it
 	}
 }
@@ -336,7 +351,7 @@ static void doWaveTerrain(BASE_OBJECT *psObj)
 		if (seen)
 		{
 			// Can see this tile.
-			psTile->tileExploredBits |= alliancebits[rayPlayer];                        // Share exploration with allies too
+			exploreTile(psTile, mapX, mapY, alliancebits[rayPlayer]);                   // Share exploration with allies too
 			visMarkTile(psObj, mapX, mapY, psTile, psObj->watchedTiles);   // Mark this tile as seen by our sensor
 		}
 	}
@@ -419,7 +434,7 @@ void visRemoveVisibility(BASE_OBJECT *psObj)
 					psTile->jammerBits &= ~(1 << psObj->player);
 				}
 			}
-			updateTileVis(psTile);
+			updateTileVis(psTile, pos.x, pos.y);
 		}
 	}
 	psObj->watchedTiles.clear();
@@ -475,6 +490,7 @@ void revealAll(UBYTE player)
 			psTile->tileExploredBits |= alliancebits[player];
 		}
 	}
+	radarMarkAllDirty();
 
 	//the objects gets revealed in processVisibility()
 }
@@ -942,42 +958,40 @@ void	setUnderTilesVis(BASE_OBJECT *psObj, UDWORD player)
 			psTile = mapTile(mapX + i, mapY + j);
 			if (psTile)
 			{
-				psTile->tileExploredBits |= alliancebits[player];
+				exploreTile(psTile, mapX + i, mapY + j, alliancebits[player]);
 			}
 		}
 	}
 }
 
-//forward declaration
+//forward declarations
+static Vector3i fireLineMuzzle(const SIMPLE_OBJECT *psViewer, int weapon_slot);
+static int checkFireLine(Vector3i muzzle, const BASE_OBJECT *psTarget, bool wallsBlock, bool direct);
 static int checkFireLine(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock, bool direct);
 
-/**
- * Check whether psViewer can fire directly at psTarget.
- * psTarget can be any type of BASE_OBJECT (e.g. a tree).
- */
-bool lineOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock)
+static const WEAPON_STATS *lineOfFireStats(const SIMPLE_OBJECT *psViewer, int weapon_slot)
 {
-	WEAPON_STATS *psStats = nullptr;
-
-	ASSERT_OR_RETURN(false, psViewer != nullptr, "Invalid shooter pointer!");
-	ASSERT_OR_RETURN(false, psTarget != nullptr, "Invalid target pointer!");
-	ASSERT_OR_RETURN(false, psViewer->type == OBJ_DROID || psViewer->type == OBJ_STRUCTURE, "Bad viewer type");
-
 	if (psViewer->type == OBJ_DROID)
 	{
-		psStats = ((const DROID*)psViewer)->getWeaponStats(weapon_slot);
+		return ((const DROID*)psViewer)->getWeaponStats(weapon_slot);
 	}
 	else if (psViewer->type == OBJ_STRUCTURE)
 	{
-		psStats = ((const STRUCTURE*)psViewer)->getWeaponStats(weapon_slot);
+		return ((const STRUCTURE*)psViewer)->getWeaponStats(weapon_slot);
 	}
+	return nullptr;
+}
+
+/// lineOfFire(), given the shooter's weapon stats, long range and muzzle position.
+static bool lineOfFire(const SIMPLE_OBJECT *psViewer, const WEAPON_STATS *psStats, int longRange, Vector3i muzzle, const BASE_OBJECT *psTarget, bool wallsBlock)
+{
 	// 2d distance
 	int distance = iHypot((psTarget->pos - psViewer->pos).xy());
-	int range = proj_GetLongRange(*psStats, psViewer->player);
+	int range = longRange;
 	if (proj_Direct(psStats))
 	{
 		/** direct shots could collide with ground **/
-		return range >= distance && LINE_OF_FIRE_MINIMUM <= checkFireLine(psViewer, psTarget, weapon_slot, wallsBlock, true);
+		return range >= distance && LINE_OF_FIRE_MINIMUM <= checkFireLine(muzzle, psTarget, wallsBlock, true);
 	}
 	else
 	{
@@ -985,7 +999,7 @@ bool lineOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int
 		 * indirect shots always have a line of fire, IF the forced
 		 * minimum angle doesn't move it out of range
 		 **/
-		int min_angle = checkFireLine(psViewer, psTarget, weapon_slot, wallsBlock, false);
+		int min_angle = checkFireLine(muzzle, psTarget, wallsBlock, false);
 		// NOTE This code seems similar to the code in combFire in combat.cpp.
 		if (min_angle > DEG(PROJ_MAX_PITCH))
 		{
@@ -998,6 +1012,42 @@ bool lineOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int
 	}
 }
 
+/**
+ * Check whether psViewer can fire directly at psTarget.
+ * psTarget can be any type of BASE_OBJECT (e.g. a tree).
+ */
+bool lineOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock)
+{
+	ASSERT_OR_RETURN(false, psViewer != nullptr, "Invalid shooter pointer!");
+	ASSERT_OR_RETURN(false, psTarget != nullptr, "Invalid target pointer!");
+	ASSERT_OR_RETURN(false, psViewer->type == OBJ_DROID || psViewer->type == OBJ_STRUCTURE, "Bad viewer type");
+
+	const WEAPON_STATS *psStats = lineOfFireStats(psViewer, weapon_slot);
+	return lineOfFire(psViewer, psStats, proj_GetLongRange(*psStats, psViewer->player), fireLineMuzzle(psViewer, weapon_slot), psTarget, wallsBlock);
+}
+
+LineOfFireChecker::LineOfFireChecker(const SIMPLE_OBJECT *psViewer, int weapon_slot, bool wallsBlock)
+	: psViewer(psViewer)
+	, psStats(nullptr)
+	, longRange(0)
+	, wallsBlock(wallsBlock)
+{
+	ASSERT_OR_RETURN(, psViewer != nullptr, "Invalid shooter pointer!");
+	ASSERT_OR_RETURN(, psViewer->type == OBJ_DROID || psViewer->type == OBJ_STRUCTURE, "Bad viewer type");
+
+	psStats = lineOfFireStats(psViewer, weapon_slot);
+	longRange = proj_GetLongRange(*psStats, psViewer->player);
+	muzzle = fireLineMuzzle(psViewer, weapon_slot);
+}
+
+bool LineOfFireChecker::operator()(const BASE_OBJECT *psTarget) const
+{
+	ASSERT_OR_RETURN(false, psStats != nullptr, "Invalid shooter");
+	ASSERT_OR_RETURN(false, psTarget != nullptr, "Invalid target pointer!");
+
+	return lineOfFire(psViewer, psStats, longRange, muzzle, psTarget, wallsBlock);
+}
+
 /* Check how much of psTarget is hitable from psViewer's gun position */
 int areaOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock)
 {
@@ -1047,24 +1097,10 @@ static inline void angle_check(int64_t *angletan, int positionSq, int height, in
 	*angletan = std::max(*angletan, current);
 }
 
-/**
- * Check fire line from psViewer to psTarget
- * psTarget can be any type of BASE_OBJECT (e.g. a tree).
- */
-static int checkFireLine(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock, bool direct)
+/* helper function for checkFireLine, the position lines of fire start from */
+static Vector3i fireLineMuzzle(const SIMPLE_OBJECT *psViewer, int weapon_slot)
 {
-	Vector3i pos(0, 0, 0), dest(0, 0, 0);
-	Vector2i start(0, 0), diff(0, 0), current(0, 0), halfway(0, 0), next(0, 0), part(0, 0);
 	Vector3i muzzle(0, 0, 0);
-	int distSq, partSq, oldPartSq;
-	int64_t angletan;
-
-	ASSERT(psViewer != nullptr, "Invalid shooter pointer!");
-	ASSERT(psTarget != nullptr, "Invalid target pointer!");
-	if (!psViewer || !psTarget)
-	{
-		return -1;
-	}
 
 	/* CorvusCorax: get muzzle offset (code from projectile.c)*/
 	if (psViewer->type == OBJ_DROID && weapon_slot >= 0)
@@ -1079,6 +1115,34 @@ static int checkFireLine(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTar
 	{
 		muzzle = psViewer->pos;
 	}
+	return muzzle;
+}
+
+/**
+ * Check fire line from psViewer to psTarget
+ * psTarget can be any type of BASE_OBJECT (e.g. a tree).
+ */
+static int checkFireLine(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock, bool direct)
+{
+	ASSERT(psViewer != nullptr, "Invalid shooter pointer!");
+	ASSERT(psTarget != nullptr, "Invalid target pointer!");
+	if (!psViewer || !psTarget)
+	{
+		return -1;
+	}
+
+	return checkFireLine(fireLineMuzzle(psViewer, weapon_slot), psTarget, wallsBlock, direct);
+}
+
+/**
+ * Check fire line from the muzzle position to psTarget
+ */
+static int checkFireLine(Vector3i muzzle, const BASE_OBJECT *psTarget, bool wallsBlock, bool direct)
+{
+	Vector3i pos(0, 0, 0), dest(0, 0, 0);
+	Vector2i start(0, 0), diff(0, 0), current(0, 0), halfway(0, 0), next(0, 0), part(0, 0);
+	int distSq, partSq, oldPartSq;
+	int64_t angletan;
 
 	pos = muzzle;
 	dest = psTarget->pos;
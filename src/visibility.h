@@ -46,6 +46,21 @@ int visibleObject(const BASE_OBJECT *psViewer, const BASE_OBJECT *psTarget, bool
 /** Can shooter hit target with direct fire weapon? */
 bool lineOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock);
 
+/** Checks lineOfFire() from one weapon against many targets, looking up the weapon's stats, range and muzzle position only once. */
+class LineOfFireChecker
+{
+public:
+	LineOfFireChecker(const SIMPLE_OBJECT *psViewer, int weapon_slot, bool wallsBlock);
+	bool operator()(const BASE_OBJECT *psTarget) const;
+
+private:
+	const SIMPLE_OBJECT *psViewer;
+	const WEAPON_STATS *psStats;
+	int longRange;
+	Vector3i muzzle = Vector3i(0, 0, 0);
+	bool wallsBlock;
+};
+
 /** How much of target can the player hit with direct fire weapon? */
 int areaOfFire(const SIMPLE_OBJECT *psViewer, const BASE_OBJECT *psTarget, int weapon_slot, bool wallsBlock);
 
@@ -36,6 +36,7 @@
 
 #include "action.h"
 #include "clparse.h"
+#include "benchmark.h"
 #include "combat.h"
 #include "console.h"
 #include "design.h"
@@ -1234,7 +1235,7 @@ wzapi::researchResults wzapi::enumResearch(WZAPI_NO_PARAMS)
 	researchResults result;
 	int player = context.player();
 	SCRIPT_ASSERT_PLAYER({}, context, player);
-	for (int i = 0; i < asResearch.size(); i++)
+	for (uint16_t i : researchCandidateList(player))
 	{
 		RESEARCH *psResearch = &asResearch[i];
 		if (!IsResearchCompleted(&asPlayerResList[player][i]) && researchAvailable(i, player, ModeQueue))
@@ -2524,7 +2525,11 @@ bool wzapi::gameOverMessage(WZAPI_PARAMS(bool gameWon, optional<bool> _showBackD
 		updateChallenge(gameWon);
 	}
 	GameStoryLogger::instance().logGameOver();
-	if (autogame_enabled())
+	if (benchmarkEnabled())
+	{
+		benchmarkGameOver();
+	}
+	else if (autogame_enabled())
 	{
 		debug(LOG_WARNING, "Autogame completed successfully!");
 		if (headlessGameMode())